@@ -87,9 +87,18 @@ public:
 
 public:
 
+  /// Created by the scene when first requested, if it doesn't create
+  /// them up front, see FlowScene::setGraphicsOnDemand().
   ConnectionGraphicsObject&
   connectionGraphicsObject() const;
 
+  bool
+  hasGraphicsObject() const;
+
+  /// Destroy the graphics object, e.g. when neither node has one.
+  void
+  releaseGraphicsObject();
+
   ConnectionState const &
   connectionState() const;
   ConnectionState&
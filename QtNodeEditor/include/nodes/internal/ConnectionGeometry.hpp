@@ -4,6 +4,7 @@
 
 #include <QtCore/QPointF>
 #include <QtCore/QRectF>
+#include <QtGui/QPainterPath>
 
 #include <iostream>
 
@@ -27,9 +28,15 @@ public:
   void
   moveEndPoint(PortType portType, QPointF const &offset);
 
+  /// Cached until an end point moves.
   QRectF
   boundingRect() const;
 
+  /// The shape used for hit tests: the cubic, widened to 10 pixels.
+  /// Cached until an end point moves.
+  QPainterPath const&
+  stroke() const;
+
   std::pair<QPointF, QPointF>
   pointsC1C2() const;
 
@@ -48,6 +55,11 @@ public:
 
   void setPortLayout( PortLayout layout);
 
+private:
+
+  void
+  invalidate();
+
 private:
   // local object coordinates
   QPointF _in;
@@ -60,5 +72,11 @@ private:
   bool _hovered;
 
   PortLayout _ports_layout;
+
+  mutable QRectF _boundingRect;
+  mutable bool _boundingRectValid;
+
+  mutable QPainterPath _stroke;
+  mutable bool _strokeValid;
 };
 }
@@ -20,6 +20,10 @@ public:
 
   static void setConnectionStyle(QString jsonText);
 
+  bool operator==(ConnectionStyle const& other) const;
+
+  bool operator!=(ConnectionStyle const& other) const { return !(*this == other); }
+
 private:
 
   void loadJsonText(QString jsonText) override;
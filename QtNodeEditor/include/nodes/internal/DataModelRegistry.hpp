@@ -72,6 +72,7 @@ public:
     _registeredItemCreators[name] = std::move(creator);
     _categories.insert(category);
     _registeredModelsCategory[name] = category;
+    dropPooledModels(name);
   }
 
   void registerTypeConverter(TypeConverterId const & id,
@@ -84,10 +85,33 @@ public:
   {
       _registeredItemCreators.erase(name);
       _registeredModelsCategory.erase(name);
+      dropPooledModels(name);
   }
 
+  /// A model recycled with the same name, if any, after its
+  /// prepareForReuse(), otherwise a new one
   std::unique_ptr<NodeDataModel>create(QString const &modelName);
 
+  /// Keep a model that is not used anymore, to be returned by a later
+  /// create() instead of building a new one, together with its widgets.
+  /// The model is destroyed if it doesn't support resetToDefault(),
+  /// if its name is not registered or if the pool is full.
+  void recycle(RegistryItemPtr model);
+
+  /// Maximum number of models kept for each name. Zero disables the pool.
+  void setPoolCapacity(size_t capacity);
+
+  /// Maximum number of models kept for all the names together.
+  void setTotalPoolCapacity(size_t capacity);
+
+  size_t pooledModelsCount() const { return _pooledModelsCount; }
+
+  void clearPool()
+  {
+    _pooledModels.clear();
+    _pooledModelsCount = 0;
+  }
+
   RegisteredModelCreatorsMap const &registeredModelCreators() const;
 
   RegisteredModelsCategoryMap const &registeredModelsCategoryAssociation() const;
@@ -101,6 +125,8 @@ public:
 
 private:
 
+  void dropPooledModels(QString const &name);
+
   RegisteredModelsCategoryMap _registeredModelsCategory;
 
   CategoriesSet _categories;
@@ -108,6 +134,14 @@ private:
   RegisteredModelCreatorsMap _registeredItemCreators;
 
   RegisteredTypeConvertersMap _registeredTypeConverters;
+
+  std::unordered_map<QString, std::vector<RegistryItemPtr>> _pooledModels;
+
+  size_t _poolCapacity = 1024;
+
+  size_t _totalPoolCapacity = 4096;
+
+  size_t _pooledModelsCount = 0;
 };
 
 
@@ -127,7 +161,7 @@ DataModelRegistry::
   _registeredItemCreators[name] = std::move(creator);
   _categories.insert(category);
   _registeredModelsCategory[name] = category;
-
+  dropPooledModels(name);
 }
 
 }
@@ -4,6 +4,9 @@
 #include <QtWidgets/QGraphicsScene>
 
 #include <unordered_map>
+#include <set>
+#include <deque>
+#include <vector>
 #include <tuple>
 #include <functional>
 
@@ -23,6 +26,18 @@ class NodeGraphicsObject;
 class Connection;
 class ConnectionGraphicsObject;
 class NodeStyle;
+class PlaceholderGraphicsItem;
+
+/// How much of the nodes and connections is painted, depending on the zoom.
+enum class DetailLevel
+{
+  /// Everything, embedded widgets included.
+  Full,
+  /// Flat colours and connection points; no widgets, labels or shadows.
+  Simplified,
+  /// A filled rect per node and straight connections.
+  Schematic
+};
 
 /// Scene holds connections and nodes.
 class NODE_EDITOR_PUBLIC FlowScene
@@ -77,6 +92,61 @@ public:
   void setNodePosition(Node& node, const QPointF& pos) const;
 
   QSizeF getNodeSize(const Node& node) const;
+
+  /// Bounding rect of all the nodes, with or without a graphics object.
+  QRectF nodesBoundingRect() const;
+
+public:
+
+  /// Create the graphics objects of the nodes only when they are requested,
+  /// e.g. for the ones close to the visible area of a large scene. The other
+  /// nodes, and the connections between them, are painted by a single item
+  /// as they would be by their own graphics objects, but they can't be
+  /// selected, hovered or edited. Disabling it creates all the missing ones.
+  void setGraphicsOnDemand(bool enabled);
+
+  bool graphicsOnDemand() const;
+
+  /// Create the graphics object of the node, if it has none yet, and the
+  /// ones of its connections. Emits nodeGraphicsCreated().
+  void createNodeGraphics(Node& node);
+
+  /// Destroy the graphics object of the node, and the ones of its connections
+  /// whose other node has none. Return false, doing nothing, if the user is
+  /// interacting with them: selected, hovered, focused or grabbing the mouse.
+  bool releaseNodeGraphics(Node& node);
+
+  /// Emits connectionGraphicsCreated().
+  void createConnectionGraphics(Connection& connection);
+
+  /// Repaint the node, with or without a graphics object.
+  void updateNode(const Node& node);
+
+  void updateConnection(const Connection& connection);
+
+  /// Move the connections of the node to its ports, or defer it
+  /// until the end of the batch.
+  void moveNodeConnections(const Node& node);
+
+public:
+
+  /// The scene seen as a forest: the parent of a node is the one connected
+  /// to its first input port. Maintained as the connections change,
+  /// therefore these queries don't visit the scene.
+
+  /// The only node without a parent, or nullptr if there are none or many.
+  Node* rootNode() const;
+
+  /// nullptr if the node has no parent.
+  Node* parentNode(const Node& node) const;
+
+  /// Children of the node, in the order their connections were made.
+  std::vector<Node*> const & childNodes(const Node& node) const;
+
+  /// Refresh the parent of the node, after the connections of its
+  /// input port changed.
+  void updateTopology(Node& node);
+
 public:
 
   std::unordered_map<QUuid, std::unique_ptr<Node> > const &nodes() const;
@@ -97,10 +167,85 @@ public:
 
   void loadFromMemory(const QByteArray& data);
 
+  /// Compact alternative to saveToMemory(). The encoding is deterministic:
+  /// nodes are sorted by id, each followed by the connections of its input
+  /// ports, therefore equal scenes produce equal bytes.
+  QByteArray saveToBinary() const;
+
+  void loadFromBinary(const QByteArray& data);
+
+  /// The part of saveToBinary() that describes a single node,
+  /// including the connections of its input ports.
+  static QByteArray saveNodeToBinary(const Node& node);
+
+  /// Same result of saveToBinary(), given the output of saveNodeToBinary()
+  /// for each node, sorted by id.
+  static QByteArray joinNodesToBinary(QtNodes::PortLayout layout,
+                                      const std::vector<QByteArray>& nodes);
+
+  /// Decode the output of saveNodeToBinary() into the objects accepted by
+  /// restoreNode() and restoreConnection(). Return false if it is invalid.
+  static bool readNodeFromBinary(const QByteArray& data,
+                                 QJsonObject& nodeJson,
+                                 std::vector<QJsonObject>& connectionsJson);
+
   void setLayout( QtNodes::PortLayout layout);
 
   QtNodes::PortLayout layout() const;
 
+  DetailLevel detailLevel() const;
+
+  /// Chosen by the view, according to its zoom.
+  void setDetailLevel(DetailLevel level);
+
+  /// Incremented by any change of the nodes, their connections, positions
+  /// or sizes. Anything derived from the scene is up to date as long as
+  /// the revision doesn't change.
+  quint64 revision() const;
+
+  /// Increment the revision, when the content of a node changed
+  /// without the scene being aware of it.
+  void touch();
+
+  /// Like touch(), remembering which node changed.
+  void touch(const Node& node);
+
+  /// Nodes touched since the last call. Some of them might not exist anymore.
+  std::set<QUuid> takeTouchedNodes();
+
+  /// The nodes touched after the given revision, some of them might not
+  /// exist anymore. Return false if they are not known, because of a
+  /// touch() without a node or of too many changes since then.
+  bool touchedNodesSince(quint64 revision, std::set<QUuid>& nodes) const;
+
+  /// Incremented when nodes or connections are created or removed, or
+  /// when the parent of a node changes. Unlike revision(), not by moves
+  /// or by changes of the content of the nodes.
+  quint64 topologyRevision() const;
+
+  /// Start a group of changes, like the creation of a whole tree.
+  /// Until the matching commitBatch(), the signals nodeCreated() and
+  /// connectionCreated() are deferred, and so is the geometry of the
+  /// connections attached to the nodes being moved or resized.
+  /// Batches can be nested.
+  void beginBatch();
+
+  /// Emit the deferred signals of the nodes and connections that still exist,
+  /// in order of creation, move each affected connection once and
+  /// finally emit batchCommitted().
+  void commitBatch();
+
+  /// Leave a batch without emitting anything, e.g. while an exception
+  /// propagates: the nodes and connections created in it are never
+  /// announced, the scene is expected to be cleared or loaded again.
+  void abandonBatch();
+
+  bool inBatch() const;
+
+  /// Called by the nodes being moved or resized. Return false if the scene
+  /// is not in a batch, i.e. the connections must be moved immediately.
+  bool deferMoveConnections(const Node& node);
+
 signals:
 
   void nodeCreated(Node &n);
@@ -115,7 +260,7 @@ signals:
 
   void nodeMoved(Node& n, const QPointF& newLocation);
 
-  void nodeDoubleClicked(Node& n);
+  void nodeDoubleClicked(Node& n, const QPointF& pos);
 
   void connectionHovered(Connection& c, QPoint screenPos);
 
@@ -127,6 +272,15 @@ signals:
 
   void nodeContextMenu(Node& n, const QPointF& pos);
 
+  /// A batch was committed: one notification for all its changes.
+  void batchCommitted();
+
+  /// See setGraphicsOnDemand(). The flags of the new object, e.g. whether it
+  /// can be moved, are the defaults and might need to be applied again.
+  void nodeGraphicsCreated(Node& n);
+
+  void connectionGraphicsCreated(Connection& c);
+
 private:
 
   using SharedConnection = std::shared_ptr<Connection>;
@@ -138,6 +292,68 @@ private:
 
   QtNodes::PortLayout _layout;
 
+  DetailLevel _detailLevel;
+
+  bool _graphicsOnDemand;
+  // paints the nodes without a graphics object, while _graphicsOnDemand
+  std::unique_ptr<PlaceholderGraphicsItem> _placeholders;
+
+  quint64 _revision;
+  quint64 _topology_revision;
+
+  std::set<QUuid> _touched_nodes;
+
+  // (revision, node) of the latest touches
+  std::deque<std::pair<quint64, QUuid>> _touch_log;
+  // touchedNodesSince() can't tell what changed up to this revision
+  quint64 _touch_log_begin;
+
+  std::unordered_map<QUuid, Node*> _parents;
+  std::unordered_map<QUuid, std::vector<Node*>> _children;
+  std::set<QUuid> _parentless_nodes;
+
+  int _batch_depth;
+  std::vector<QUuid> _batch_created_nodes;
+  std::vector<QUuid> _batch_created_connections;
+  std::set<QUuid> _batch_moved_nodes;
+};
+
+/// Begin a batch of the scene on construction. The caller commits it
+/// with commit() once the changes are complete; a batch left without
+/// commit(), e.g. by an exception, is abandoned on destruction.
+class FlowSceneBatch
+{
+public:
+  explicit FlowSceneBatch(FlowScene& scene)
+    : _scene(scene)
+    , _done(false)
+  {
+    _scene.beginBatch();
+  }
+
+  ~FlowSceneBatch()
+  {
+    if (!_done)
+      _scene.abandonBatch();
+  }
+
+  void
+  commit()
+  {
+    if (_done)
+      return;
+
+    _done = true;
+    _scene.commitBatch();
+  }
+
+  FlowSceneBatch(const FlowSceneBatch&) = delete;
+  FlowSceneBatch& operator=(const FlowSceneBatch&) = delete;
+
+private:
+  FlowScene& _scene;
+
+  bool _done;
 };
 
 Node*
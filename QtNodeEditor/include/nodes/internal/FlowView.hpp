@@ -8,6 +8,7 @@ namespace QtNodes
 {
 
 class FlowScene;
+enum class DetailLevel;
 
 class NODE_EDITOR_PUBLIC FlowView
   : public QGraphicsView
@@ -27,6 +28,29 @@ public:
 
   void setScene(FlowScene *scene);
 
+  /// The detail level for the current zoom, given to the scene whenever
+  /// the transform changes.
+  DetailLevel detailLevel() const;
+
+  /// The QGraphicsView ones, followed by an update of the detail level
+  /// of the scene. Those of QGraphicsView must not be called directly.
+  void scale(qreal sx, qreal sy);
+
+  void setTransform(const QTransform &matrix, bool combine = false);
+
+  void resetTransform();
+
+  void fitInView(const QRectF &rect, Qt::AspectRatioMode aspectRatioMode = Qt::IgnoreAspectRatio);
+
+  /// Paint on a multisampled QOpenGLWidget instead of the raster viewport.
+  /// Return false, keeping the current viewport, if OpenGL is not available.
+  bool setOpenGLViewport(bool enabled, int samples = 4);
+
+  bool isOpenGLViewport() const;
+
+  /// Whether the views created from now on use OpenGL. Off by default.
+  static void setOpenGLByDefault(bool enabled);
+
 public slots:
 
   void scaleUp();
@@ -41,6 +65,10 @@ signals:
 
   void finishNodeDelete();
 
+  /// The part of the scene that is shown changed: it was panned, zoomed
+  /// or resized. Emitted by the next paint.
+  void visibleAreaChanged();
+
 protected:
 
   void contextMenuEvent(QContextMenuEvent *event) override;
@@ -59,12 +87,16 @@ protected:
 
   void showEvent(QShowEvent *event) override;
 
+  void paintEvent(QPaintEvent *event) override;
+
 protected:
 
   FlowScene * scene();
 
 private:
 
+  void updateDetailLevel();
+
   QAction* _clearSelectionAction;
 
   QAction* _deleteSelectionAction;
@@ -72,5 +104,7 @@ private:
   QPointF _clickPos;
 
   FlowScene* _scene;
+
+  QRectF _visibleArea;
 };
 }
@@ -2,6 +2,7 @@
 
 
 #include <QtCore/QObject>
+#include <QtCore/QPointF>
 #include <QtCore/QUuid>
 
 #include <QtCore/QJsonObject>
@@ -22,6 +23,7 @@ namespace QtNodes
 
 class Connection;
 class ConnectionState;
+class FlowScene;
 class NodeGraphicsObject;
 class NodeDataModel;
 
@@ -34,7 +36,8 @@ class NODE_EDITOR_PUBLIC Node
 public:
 
   /// NodeDataModel should be an rvalue and is moved into the Node
-  Node(std::unique_ptr<NodeDataModel> && dataModel);
+  Node(std::unique_ptr<NodeDataModel> && dataModel,
+       FlowScene& scene);
 
   virtual
   ~Node();
@@ -61,15 +64,38 @@ public:
 
 public:
 
+  FlowScene &
+  flowScene() const;
+
+  /// Created by the scene when first requested, if it doesn't create
+  /// them up front, see FlowScene::setGraphicsOnDemand().
   NodeGraphicsObject const &
   nodeGraphicsObject() const;
 
   NodeGraphicsObject &
   nodeGraphicsObject();
 
+  bool
+  hasGraphicsObject() const;
+
   void
   setGraphicsObject(std::unique_ptr<NodeGraphicsObject>&& graphics);
 
+  /// Destroy the graphics object, keeping its position. The embedded
+  /// widget is given back to the model.
+  void
+  releaseGraphicsObject();
+
+  /// Position in the scene, with or without a graphics object.
+  QPointF
+  position() const;
+
+  void
+  setPosition(QPointF const& pos);
+
+  QTransform
+  sceneTransform() const;
+
   NodeGeometry&
   nodeGeometry();
 
@@ -85,6 +111,11 @@ public:
   NodeDataModel*
   nodeDataModel() const;
 
+  /// Take the model away, with its embedded widget, to be reused by
+  /// another node. This node can only be destroyed afterwards.
+  std::unique_ptr<NodeDataModel>
+  releaseDataModel();
+
 public slots: // data propagation
 
   /// Propagates incoming data to the underlying model.
@@ -101,12 +132,18 @@ public slots: // data propagation
   void
   onNodeSizeUpdated();
 
+  /// embed the new widget of the model, if any
+  void
+  onEmbeddedWidgetReplaced();
+
 private:
 
   // addressing
 
   QUuid _uid;
 
+  FlowScene& _scene;
+
   // data
 
   std::unique_ptr<NodeDataModel> _nodeDataModel;
@@ -117,6 +154,9 @@ private:
 
   NodeGeometry _nodeGeometry;
 
+  // position while there is no graphics object
+  QPointF _pos;
+
   std::unique_ptr<NodeGraphicsObject> _nodeGraphicsObject;
 };
 }
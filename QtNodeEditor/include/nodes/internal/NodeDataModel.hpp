@@ -105,6 +105,19 @@ public:
   virtual
   NodePainterDelegate* painterDelegate() const { return nullptr; }
 
+  /// Bring the model back to the state of a new instance, to be reused
+  /// by another node (see DataModelRegistry::recycle()).
+  /// Return false if the model can't be reused, the default.
+  virtual
+  bool
+  resetToDefault() { return false; }
+
+  /// Called by DataModelRegistry::create() when a recycled model is handed
+  /// out again, to take the settings that a new instance would get now.
+  virtual
+  void
+  prepareForReuse() {}
+
 signals:
 
   void
@@ -121,6 +134,15 @@ signals:
 
   void embeddedWidgetSizeUpdated();
 
+  /// embeddedWidget() returns a different widget, or none
+  void embeddedWidgetReplaced();
+
+protected:
+
+  /// Set the style of a new instance
+  void
+  resetNodeStyle();
+
 private:
 
   NodeStyle _nodeStyle;
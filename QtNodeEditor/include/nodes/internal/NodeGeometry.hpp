@@ -3,6 +3,7 @@
 #include <QtCore/QRectF>
 #include <QtCore/QPointF>
 #include <QtGui/QTransform>
+#include <QtGui/QFont>
 #include <QtGui/QFontMetrics>
 
 #include "PortType.hpp"
@@ -85,10 +86,18 @@ public:
   void
   recalculateSize() const;
 
-  /// Updates size if the QFontMetrics is changed
+  /// Updates size if the font changed or invalidate() was called since
+  /// the last update. Called by every paint.
   void
   recalculateSize(QFont const &font) const;
 
+  /// The size is obsolete; it is updated by the next recalculateSize().
+  void
+  invalidate() { _dirty = true; }
+
+  bool
+  isDirty() const { return _dirty; }
+
   // TODO removed default QTransform()
   QPointF
   portScenePosition(PortIndex index,
@@ -103,10 +112,15 @@ public:
   QRect
   resizeRect() const;
 
-  /// Returns the position of a widget on the Node surface
+  /// Returns the position of a widget on the Node surface, or of the
+  /// area painted by the NodePainterDelegate in place of it
   QPointF
   widgetPosition() const;
 
+  /// Size of the embedded widget, or of the area painted in place of it
+  QSize
+  contentSize() const;
+
   unsigned int
   validationHeight() const;
 
@@ -147,9 +161,12 @@ private:
 
   std::unique_ptr<NodeDataModel> const &_dataModel;
 
+  mutable QFont _font;
   mutable QFontMetrics _fontMetrics;
   mutable QFontMetrics _boldFontMetrics;
 
+  mutable bool _dirty;
+
   PortLayout _ports_layout;
 };
 }
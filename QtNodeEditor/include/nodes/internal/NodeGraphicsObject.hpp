@@ -57,6 +57,15 @@ public:
   void
   updateEmbeddedQWidget();
 
+  /// Give the embedded widget back to the model, instead of
+  /// destroying it together with this object.
+  void
+  detachEmbeddedWidget();
+
+  /// Show the embedded widget only at full detail.
+  void
+  updateDetailLevel();
+
 protected:
   void
   paint(QPainter*                       painter,
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QPainter>
+#include <QtCore/QSize>
 
 #include "NodeGeometry.hpp"
 #include "NodeDataModel.hpp"
@@ -21,5 +22,15 @@ public:
   paint(QPainter* painter,
         NodeGeometry const& geom,
         NodeDataModel const * model) = 0;
+
+  /// Size of the area painted in place of the embedded widget, at
+  /// NodeGeometry::widgetPosition(). Only used if the model has no
+  /// embedded widget.
+  virtual QSize
+  size(NodeDataModel const * model) const
+  {
+    Q_UNUSED(model);
+    return QSize();
+  }
 };
 }
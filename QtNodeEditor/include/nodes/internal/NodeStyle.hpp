@@ -20,6 +20,10 @@ public:
 
   static void setNodeStyle(QString jsonText);
 
+  bool operator==(NodeStyle const& other) const;
+
+  bool operator!=(NodeStyle const& other) const { return !(*this == other); }
+
 private:
 
   void loadJsonText(QString jsonText) override;
@@ -72,12 +72,12 @@ Connection::
 
   if (_inNode)
   {
-    _inNode->nodeGraphicsObject().update();
+    _inNode->flowScene().updateNode(*_inNode);
   }
 
   if (_outNode)
   {
-    _outNode->nodeGraphicsObject().update();
+    _outNode->flowScene().updateNode(*_outNode);
   }
 }
 
@@ -183,8 +183,7 @@ setGraphicsObject(std::unique_ptr<ConnectionGraphicsObject>&& graphics)
 
     auto node = getNode(attachedPort);
 
-    QTransform nodeSceneTransform =
-      node->nodeGraphicsObject().sceneTransform();
+    QTransform nodeSceneTransform = node->sceneTransform();
 
     QPointF pos = node->nodeGeometry().portScenePosition(attachedPortIndex,
                                                          attachedPort,
@@ -260,10 +259,30 @@ ConnectionGraphicsObject&
 Connection::
 connectionGraphicsObject() const
 {
+  // only the connections between two nodes can lack one
+  if (!_connectionGraphicsObject)
+    _inNode->flowScene().createConnectionGraphics(const_cast<Connection&>(*this));
+
   return *_connectionGraphicsObject;
 }
 
 
+bool
+Connection::
+hasGraphicsObject() const
+{
+  return _connectionGraphicsObject != nullptr;
+}
+
+
+void
+Connection::
+releaseGraphicsObject()
+{
+  _connectionGraphicsObject.reset();
+}
+
+
 ConnectionState&
 Connection::
 connectionState()
@@ -16,6 +16,8 @@ ConnectionGeometry()
   , _lineWidth(3.0)
   , _hovered(false)
   , _ports_layout( PortLayout::Horizontal )
+  , _boundingRectValid(false)
+  , _strokeValid(false)
 { }
 
 QPointF const&
@@ -45,8 +47,9 @@ setEndPoint(PortType portType, QPointF const& point)
       break;
 
     default:
-      break;
+      return;
   }
+  invalidate();
 }
 
 
@@ -65,8 +68,9 @@ moveEndPoint(PortType portType, QPointF const &offset)
       break;
 
     default:
-      break;
+      return;
   }
+  invalidate();
 }
 
 
@@ -74,6 +78,9 @@ QRectF
 ConnectionGeometry::
 boundingRect() const
 {
+  if (_boundingRectValid)
+    return _boundingRect;
+
   auto points = pointsC1C2();
 
   QRectF basicRect = QRectF(_out, _in).normalized();
@@ -92,7 +99,50 @@ boundingRect() const
   commonRect.setTopLeft(commonRect.topLeft() - cornerOffset);
   commonRect.setBottomRight(commonRect.bottomRight() + 2 * cornerOffset);
 
-  return commonRect;
+  _boundingRect = commonRect;
+  _boundingRectValid = true;
+
+  return _boundingRect;
+}
+
+
+QPainterPath const&
+ConnectionGeometry::
+stroke() const
+{
+  if (_strokeValid)
+    return _stroke;
+
+  auto c1c2 = pointsC1C2();
+
+  QPointF const& p0 = _out;
+  QPointF const& p1 = c1c2.first;
+  QPointF const& p2 = c1c2.second;
+  QPointF const& p3 = _in;
+
+  QPainterPath polyline(p0);
+
+  unsigned segments = 20;
+
+  // evaluated directly: QPainterPath::pointAtPercent() measures
+  // the length of the curve at every call
+  for (auto i = 0ul; i < segments; ++i)
+  {
+    double t = double(i + 1) / segments;
+    double u = 1.0 - t;
+
+    polyline.lineTo(u * u * u * p0 +
+                    3 * u * u * t * p1 +
+                    3 * u * t * t * p2 +
+                    t * t * t * p3);
+  }
+
+  QPainterPathStroker stroker; stroker.setWidth(10.0);
+
+  _stroke = stroker.createStroke(polyline);
+  _strokeValid = true;
+
+  return _stroke;
 }
 
 
@@ -138,5 +188,18 @@ pointsC1C2() const
 
 void ConnectionGeometry::setPortLayout(QtNodes::PortLayout layout)
 {
-  _ports_layout = layout;
+  if (_ports_layout != layout)
+  {
+    _ports_layout = layout;
+    invalidate();
+  }
+}
+
+
+void
+ConnectionGeometry::
+invalidate()
+{
+  _boundingRectValid = false;
+  _strokeValid = false;
 }
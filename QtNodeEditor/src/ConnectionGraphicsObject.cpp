@@ -104,23 +104,27 @@ move()
   {
     if (auto node = _connection.getNode(portType))
     {
-      auto const &nodeGraphics = node->nodeGraphicsObject();
-
       auto const &nodeGeom = node->nodeGeometry();
 
+      // the other node might have no graphics object
       QPointF scenePos =
         nodeGeom.portScenePosition(_connection.getPortIndex(portType),
                                    portType,
-                                   nodeGraphics.sceneTransform());
+                                   node->sceneTransform());
 
       QTransform sceneTransform = this->sceneTransform();
 
       QPointF connectionPos = sceneTransform.inverted().map(scenePos);
 
+      // the shape is cached by the geometry until an end point moves
+      if (connectionPos == _connection.connectionGeometry().getEndPoint(portType))
+        continue;
+
+      _connection.connectionGraphicsObject().setGeometryChanged();
+
       _connection.connectionGeometry().setEndPoint(portType,
                                                    connectionPos);
 
-      _connection.connectionGraphicsObject().setGeometryChanged();
       _connection.connectionGraphicsObject().update();
     }
   }
@@ -144,7 +148,8 @@ paint(QPainter* painter,
     painter->setClipRect(option->exposedRect);
 
   ConnectionPainter::paint(painter,
-                           _connection);
+                           _connection,
+                           _scene.detailLevel());
 }
 
 
@@ -186,6 +191,7 @@ mouseMoveEvent(QGraphicsSceneMouseEvent* event)
 
   if (requiredPort != PortType::None)
   {
+    prepareGeometryChange();
     _connection.connectionGeometry().moveEndPoint(requiredPort, offset);
   }
 
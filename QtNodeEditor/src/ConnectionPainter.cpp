@@ -6,6 +6,7 @@
 #include "ConnectionState.hpp"
 #include "ConnectionGraphicsObject.hpp"
 #include "Connection.hpp"
+#include "FlowScene.hpp"
 
 #include "NodeData.hpp"
 
@@ -15,6 +16,17 @@
 using QtNodes::ConnectionPainter;
 using QtNodes::ConnectionGeometry;
 using QtNodes::Connection;
+using QtNodes::DetailLevel;
+
+
+// painted without a graphics object too, see FlowScene::setGraphicsOnDemand()
+static
+bool
+isSelected(Connection const & connection)
+{
+  return connection.hasGraphicsObject() &&
+         connection.connectionGraphicsObject().isSelected();
+}
 
 
 static
@@ -39,22 +51,7 @@ QPainterPath
 ConnectionPainter::
 getPainterStroke(ConnectionGeometry const& geom)
 {
-  auto cubic = cubicPath(geom);
-
-  QPointF const& source = geom.source();
-  QPainterPath result(source);
-
-  unsigned segments = 20;
-
-  for (auto i = 0ul; i < segments; ++i)
-  {
-    double ratio = double(i + 1) / segments;
-    result.lineTo(cubic.pointAtPercent(ratio));
-  }
-
-  QPainterPathStroker stroker; stroker.setWidth(10.0);
-
-  return stroker.createStroke(result);
+  return geom.stroke();
 }
 
 
@@ -138,10 +135,7 @@ drawHoveredOrSelected(QPainter * painter,
   ConnectionGeometry const& geom = connection.connectionGeometry();
   bool const hovered = geom.hovered();
 
-  auto const& graphicsObject =
-    connection.connectionGraphicsObject();
-
-  bool const selected = graphicsObject.isSelected();
+  bool const selected = isSelected(connection);
 
   // drawn as a fat background
   if (hovered || selected)
@@ -214,8 +208,7 @@ drawNormalLine(QPainter * painter,
 
   p.setWidth(lineWidth);
 
-  auto const& graphicsObject = connection.connectionGraphicsObject();
-  bool const selected = graphicsObject.isSelected();
+  bool const selected = isSelected(connection);
 
 
   auto cubic = cubicPath(geom);
@@ -276,11 +269,56 @@ drawNormalLine(QPainter * painter,
 }
 
 
+static
+void
+drawPlainLine(QPainter * painter,
+              Connection const & connection,
+              DetailLevel level)
+{
+  using QtNodes::ConnectionState;
+
+  ConnectionState const& state =
+    connection.connectionState();
+
+  if (state.requiresPort())
+    return;
+
+  auto const & connectionStyle = connection.style();
+
+  bool const selected = isSelected(connection);
+
+  QPen p(selected ? connectionStyle.selectedColor() : connectionStyle.normalColor());
+  p.setWidth(connectionStyle.lineWidth());
+
+  painter->setPen(p);
+  painter->setBrush(Qt::NoBrush);
+
+  ConnectionGeometry const& geom = connection.connectionGeometry();
+
+  if (level == DetailLevel::Schematic)
+  {
+    painter->setRenderHint(QPainter::Antialiasing, false);
+    painter->drawLine(geom.source(), geom.sink());
+  }
+  else
+  {
+    painter->drawPath(cubicPath(geom));
+  }
+}
+
+
 void
 ConnectionPainter::
 paint(QPainter* painter,
-      Connection const &connection)
+      Connection const &connection,
+      DetailLevel level)
 {
+  if (level != DetailLevel::Full)
+  {
+    drawPlainLine(painter, connection, level);
+    return;
+  }
+
   drawHoveredOrSelected(painter, connection);
 
   drawSketchLine(painter, connection);
@@ -8,6 +8,7 @@ namespace QtNodes
 class ConnectionGeometry;
 class ConnectionState;
 class Connection;
+enum class DetailLevel;
 
 class ConnectionPainter
 {
@@ -16,7 +17,8 @@ public:
   static
   void
   paint(QPainter* painter,
-        Connection const& connection);
+        Connection const& connection,
+        DetailLevel level);
 
   static
   QPainterPath
@@ -231,3 +231,19 @@ useDataDefinedColors() const
 {
   return UseDataDefinedColors;
 }
+
+
+bool
+ConnectionStyle::
+operator==(ConnectionStyle const& other) const
+{
+  return ConstructionColor     == other.ConstructionColor &&
+         NormalColor           == other.NormalColor &&
+         SelectedColor         == other.SelectedColor &&
+         SelectedHaloColor     == other.SelectedHaloColor &&
+         HoveredColor          == other.HoveredColor &&
+         LineWidth             == other.LineWidth &&
+         ConstructionLineWidth == other.ConstructionLineWidth &&
+         PointDiameter         == other.PointDiameter &&
+         UseDataDefinedColors  == other.UseDataDefinedColors;
+}
@@ -3,6 +3,8 @@
 #include <QtCore/QFile>
 #include <QDebug>
 
+#include <algorithm>
+
 using QtNodes::DataModelRegistry;
 using QtNodes::NodeDataModel;
 using QtNodes::NodeDataType;
@@ -16,6 +18,15 @@ create(QString const &modelName)
 
   if (it != _registeredItemCreators.end())
   {
+    auto pool_it = _pooledModels.find(modelName);
+    if (pool_it != _pooledModels.end() && !pool_it->second.empty())
+    {
+      auto model = std::move(pool_it->second.back());
+      pool_it->second.pop_back();
+      _pooledModelsCount--;
+      model->prepareForReuse();
+      return model;
+    }
     return it->second();
   }
 
@@ -29,6 +40,74 @@ create(QString const &modelName)
 }
 
 
+void
+DataModelRegistry::
+recycle(RegistryItemPtr model)
+{
+  if (!model)
+    return;
+
+  QString const name = model->name();
+  if (!isRegistered(name))
+    return;
+
+  if (_pooledModelsCount >= _totalPoolCapacity)
+    return;
+
+  auto& pool = _pooledModels[name];
+  if (pool.size() < _poolCapacity && model->resetToDefault())
+  {
+    pool.push_back(std::move(model));
+    _pooledModelsCount++;
+  }
+}
+
+
+void
+DataModelRegistry::
+setPoolCapacity(size_t capacity)
+{
+  _poolCapacity = capacity;
+  _pooledModelsCount = 0;
+  for (auto& it : _pooledModels)
+  {
+    if (it.second.size() > capacity)
+      it.second.resize(capacity);
+    _pooledModelsCount += it.second.size();
+  }
+}
+
+
+void
+DataModelRegistry::
+setTotalPoolCapacity(size_t capacity)
+{
+  _totalPoolCapacity = capacity;
+  for (auto& it : _pooledModels)
+  {
+    if (_pooledModelsCount <= capacity)
+      break;
+
+    size_t const excess = std::min(it.second.size(), _pooledModelsCount - capacity);
+    it.second.resize(it.second.size() - excess);
+    _pooledModelsCount -= excess;
+  }
+}
+
+
+void
+DataModelRegistry::
+dropPooledModels(QString const &name)
+{
+  auto it = _pooledModels.find(name);
+  if (it == _pooledModels.end())
+    return;
+
+  _pooledModelsCount -= it->second.size();
+  _pooledModels.erase(it);
+}
+
+
 DataModelRegistry::RegisteredModelCreatorsMap const &
 DataModelRegistry::
 registeredModelCreators() const
@@ -2,6 +2,7 @@
 
 #include <stdexcept>
 #include <utility>
+#include <algorithm>
 
 #include <QtWidgets/QGraphicsSceneMoveEvent>
 #include <QtWidgets/QFileDialog>
@@ -23,6 +24,7 @@
 #include "ConnectionGraphicsObject.hpp"
 
 #include "Connection.hpp"
+#include "PlaceholderGraphicsItem.hpp"
 
 #include "FlowView.hpp"
 #include "DataModelRegistry.hpp"
@@ -43,6 +45,12 @@ FlowScene(std::shared_ptr<DataModelRegistry> registry,
           QObject * parent)
   : QGraphicsScene(parent)
   , _registry(std::move(registry))
+  , _detailLevel(DetailLevel::Full)
+  , _graphicsOnDemand(false)
+  , _revision(1)
+  , _topology_revision(1)
+  , _touch_log_begin(0)
+  , _batch_depth(0)
 {
   setItemIndexMethod(QGraphicsScene::NoIndex);
 }
@@ -111,13 +119,17 @@ createConnection(Node& nodeIn,
                                "doesn't provide this portIndexOut");
   }
 
-  auto cgo = detail::make_unique<ConnectionGraphicsObject>(*this, *connection);
+  // between two nodes without graphics objects, painted by _placeholders
+  std::unique_ptr<ConnectionGraphicsObject> cgo;
+  if (!_graphicsOnDemand || nodeIn.hasGraphicsObject() || nodeOut.hasGraphicsObject())
+    cgo = detail::make_unique<ConnectionGraphicsObject>(*this, *connection);
 
   nodeIn.nodeState().setConnection(PortType::In, portIndexIn, *connection);
   nodeOut.nodeState().setConnection(PortType::Out, portIndexOut, *connection);
 
   // after this function connection points are set to node port
-  connection->setGraphicsObject(std::move(cgo));
+  if (cgo)
+    connection->setGraphicsObject(std::move(cgo));
 
   connection->connectionGeometry().setPortLayout( layout() );
 
@@ -126,7 +138,14 @@ createConnection(Node& nodeIn,
 
   _connections[connection->id()] = connection;
 
-  connectionCreated(*connection);
+  updateTopology(nodeIn);
+  ++_topology_revision;
+  touch(nodeIn);
+  touch(nodeOut);
+  if (inBatch())
+    _batch_created_connections.push_back(connection->id());
+  else
+    connectionCreated(*connection);
 
   return connection;
 }
@@ -182,7 +201,8 @@ restoreConnection(QJsonObject const &connectionJson)
                      *nodeOut, portIndexOut,
                      getConverter());
 
-  connectionCreated(*connection);
+  if (!inBatch())
+    connectionCreated(*connection);
 
   connection->connectionGeometry().setPortLayout( layout() );
   return connection;
@@ -193,7 +213,20 @@ void
 FlowScene::
 deleteConnection(Connection& connection)
 {
+  for(auto portType: {PortType::In,PortType::Out})
+  {
+    if (auto node = connection.getNode(portType))
+    {
+      touch(*node);
+    }
+  }
+  touch();
+  ++_topology_revision;
   connection.removeFromNodes();
+  if (auto nodeIn = connection.getNode(PortType::In))
+  {
+    updateTopology(*nodeIn);
+  }
   _connections.erase(connection.id());
   connectionDeleted(connection);
 }
@@ -203,17 +236,22 @@ Node&
 FlowScene::
 createNode(std::unique_ptr<NodeDataModel> && dataModel)
 {
-  auto node = detail::make_unique<Node>(std::move(dataModel));
-  auto ngo  = detail::make_unique<NodeGraphicsObject>(*this, *node);
+  auto node = detail::make_unique<Node>(std::move(dataModel), *this);
 
-  node->setGraphicsObject(std::move(ngo));
+  if (!_graphicsOnDemand)
+    node->setGraphicsObject(detail::make_unique<NodeGraphicsObject>(*this, *node));
 
   auto nodePtr = node.get();
   nodePtr->nodeGeometry().setPortLayout( layout() );
   auto id = node->id();
   _nodes[id] = std::move(node);
 
-  nodeCreated(*nodePtr);
+  updateTopology(*nodePtr);
+  touch(*nodePtr);
+  if (inBatch())
+    _batch_created_nodes.push_back(id);
+  else
+    nodeCreated(*nodePtr);
   return *nodePtr;
 }
 
@@ -232,9 +270,10 @@ restoreNode(QJsonObject const& nodeJson)
                            modelName.toLocal8Bit().data());
   }
 
-  auto node = detail::make_unique<Node>(std::move(dataModel));
-  auto ngo  = detail::make_unique<NodeGraphicsObject>(*this, *node);
-  node->setGraphicsObject(std::move(ngo));
+  auto node = detail::make_unique<Node>(std::move(dataModel), *this);
+
+  if (!_graphicsOnDemand)
+    node->setGraphicsObject(detail::make_unique<NodeGraphicsObject>(*this, *node));
 
   node->restore(nodeJson);
 
@@ -246,7 +285,12 @@ restoreNode(QJsonObject const& nodeJson)
   auto id = node->id();
   _nodes[ id ] = std::move(node);
 
-  nodeCreated(*nodePtr);
+  updateTopology(*nodePtr);
+  touch(*nodePtr);
+  if (inBatch())
+    _batch_created_nodes.push_back(id);
+  else
+    nodeCreated(*nodePtr);
   return *nodePtr;
 }
 
@@ -255,9 +299,6 @@ void
 FlowScene::
 removeNode(Node& node)
 {
-  // call signal
-  nodeDeleted(node);
-
   for(auto portType: {PortType::In,PortType::Out})
   {
     auto nodeState = node.nodeState();
@@ -270,7 +311,24 @@ removeNode(Node& node)
     }
   }
 
-  _nodes.erase(node.id());
+  QUuid const id = node.id();
+  _parents.erase(id);
+  _children.erase(id);
+  _parentless_nodes.erase(id);
+  ++_topology_revision;
+
+  // out of the scene before the signal, so that whoever takes the touched
+  // nodes in a slot sees it removed
+  auto it = _nodes.find(id);
+  UniqueNode removed = std::move(it->second);
+  _nodes.erase(it);
+
+  touch(*removed);
+  nodeDeleted(*removed);
+
+  // the next node with the same model might reuse it
+  if (_registry)
+    _registry->recycle(removed->releaseDataModel());
 }
 
 
@@ -391,7 +449,7 @@ QPointF
 FlowScene::
 getNodePosition(const Node& node) const
 {
-  return node.nodeGraphicsObject().pos();
+  return node.position();
 }
 
 
@@ -399,8 +457,8 @@ void
 FlowScene::
 setNodePosition(Node& node, const QPointF& pos) const
 {
-  node.nodeGraphicsObject().setPos(pos);
-  node.nodeGraphicsObject().moveConnections();
+  node.setPosition(pos);
+  node.flowScene().moveNodeConnections(node);
 }
 
 
@@ -413,6 +471,277 @@ getNodeSize(const Node& node) const
 }
 
 
+QRectF
+FlowScene::
+nodesBoundingRect() const
+{
+  QRectF rect;
+  for (auto const & node : _nodes)
+  {
+    rect |= node.second->nodeGeometry().boundingRect()
+                .translated(node.second->position());
+  }
+  return rect;
+}
+
+
+void
+FlowScene::
+setGraphicsOnDemand(bool enabled)
+{
+  if (_graphicsOnDemand == enabled)
+    return;
+
+  _graphicsOnDemand = enabled;
+
+  if (enabled)
+  {
+    _placeholders = detail::make_unique<PlaceholderGraphicsItem>(*this);
+    addItem(_placeholders.get());
+    return;
+  }
+
+  for (auto const & node : _nodes)
+    createNodeGraphics(*node.second);
+
+  _placeholders.reset();
+}
+
+
+bool
+FlowScene::
+graphicsOnDemand() const
+{
+  return _graphicsOnDemand;
+}
+
+
+void
+FlowScene::
+createNodeGraphics(Node& node)
+{
+  if (node.hasGraphicsObject())
+    return;
+
+  node.setGraphicsObject(detail::make_unique<NodeGraphicsObject>(*this, node));
+
+  if (_placeholders)
+    _placeholders->geometryChanged();
+
+  for (PortType portType : {PortType::In, PortType::Out})
+  {
+    for (auto const & connections : node.nodeState().getEntries(portType))
+    {
+      for (auto const & con : connections)
+        createConnectionGraphics(*con.second);
+    }
+  }
+
+  nodeGraphicsCreated(node);
+}
+
+
+bool
+FlowScene::
+releaseNodeGraphics(Node& node)
+{
+  if (!node.hasGraphicsObject())
+    return true;
+
+  auto isBusy = [this](QGraphicsItem const & item)
+  {
+    return item.isSelected() ||
+           item.isUnderMouse() ||
+           mouseGrabberItem() == &item ||
+           (focusItem() && item.isAncestorOf(focusItem())) ||
+           focusItem() == &item;
+  };
+
+  if (isBusy(node.nodeGraphicsObject()))
+    return false;
+
+  // the connections left between two nodes without graphics objects
+  std::vector<Connection*> released;
+  for (PortType portType : {PortType::In, PortType::Out})
+  {
+    for (auto const & connections : node.nodeState().getEntries(portType))
+    {
+      for (auto const & con : connections)
+      {
+        Node* other = con.second->getNode(oppositePort(portType));
+        if (!con.second->hasGraphicsObject() || (other && other->hasGraphicsObject()))
+          continue;
+
+        if (isBusy(con.second->connectionGraphicsObject()))
+          return false;
+
+        released.push_back(con.second);
+      }
+    }
+  }
+
+  for (auto connection : released)
+    connection->releaseGraphicsObject();
+
+  node.releaseGraphicsObject();
+
+  if (_placeholders)
+    _placeholders->geometryChanged();
+
+  return true;
+}
+
+
+void
+FlowScene::
+createConnectionGraphics(Connection& connection)
+{
+  if (connection.hasGraphicsObject())
+    return;
+
+  connection.setGraphicsObject(
+    detail::make_unique<ConnectionGraphicsObject>(*this, connection));
+
+  connection.connectionGeometry().setPortLayout( layout() );
+
+  connectionGraphicsCreated(connection);
+}
+
+
+void
+FlowScene::
+updateNode(const Node& node)
+{
+  if (node.hasGraphicsObject())
+  {
+    // a repaint doesn't change the node
+    const_cast<NodeGraphicsObject&>(node.nodeGraphicsObject()).update();
+  }
+  else if (_placeholders)
+  {
+    _placeholders->update(node.nodeGeometry().boundingRect()
+                            .translated(node.position()));
+  }
+}
+
+
+void
+FlowScene::
+updateConnection(const Connection& connection)
+{
+  // without a graphics object, the geometry is in scene coordinates
+  if (connection.hasGraphicsObject())
+    connection.connectionGraphicsObject().update();
+  else if (_placeholders)
+    _placeholders->update(connection.connectionGeometry().boundingRect());
+}
+
+
+void
+FlowScene::
+moveNodeConnections(const Node& node)
+{
+  if (deferMoveConnections(node))
+    return;
+
+  for (PortType portType : {PortType::In, PortType::Out})
+  {
+    for (auto const & connections : node.nodeState().getEntries(portType))
+    {
+      // the others are placed by _placeholders when painted
+      for (auto const & con : connections)
+      {
+        if (con.second->hasGraphicsObject())
+          con.second->connectionGraphicsObject().move();
+      }
+    }
+  }
+}
+
+
+Node*
+FlowScene::
+rootNode() const
+{
+  if (_parentless_nodes.size() != 1)
+    return nullptr;
+
+  auto it = _nodes.find(*_parentless_nodes.begin());
+  return (it != _nodes.end()) ? it->second.get() : nullptr;
+}
+
+
+Node*
+FlowScene::
+parentNode(const Node& node) const
+{
+  auto it = _parents.find(node.id());
+  return (it != _parents.end()) ? it->second : nullptr;
+}
+
+
+std::vector<Node*> const &
+FlowScene::
+childNodes(const Node& node) const
+{
+  static const std::vector<Node*> no_children;
+
+  auto it = _children.find(node.id());
+  return (it != _children.end()) ? it->second : no_children;
+}
+
+
+void
+FlowScene::
+updateTopology(Node& node)
+{
+  Node* parent = nullptr;
+
+  auto const & entries = node.nodeState().getEntries(PortType::In);
+  if (!entries.empty())
+  {
+    for (auto const & pair : entries.front())
+    {
+      if (auto nodeOut = pair.second->getNode(PortType::Out))
+      {
+        parent = nodeOut;
+        break;
+      }
+    }
+  }
+
+  auto const id = node.id();
+  auto it = _parents.find(id);
+  Node* prevParent = (it != _parents.end()) ? it->second : nullptr;
+
+  if (prevParent == parent && (parent || _parentless_nodes.count(id)))
+    return;
+
+  ++_topology_revision;
+
+  if (prevParent)
+  {
+    auto& siblings = _children[prevParent->id()];
+    siblings.erase(std::remove(siblings.begin(), siblings.end(), &node),
+                   siblings.end());
+    if (siblings.empty())
+      _children.erase(prevParent->id());
+    _parents.erase(it);
+  }
+
+  if (parent)
+  {
+    _parents[id] = parent;
+    _children[parent->id()].push_back(&node);
+    _parentless_nodes.erase(id);
+  }
+  else
+  {
+    _parentless_nodes.insert(id);
+  }
+}
+
+
 std::unordered_map<QUuid, std::unique_ptr<Node> > const &
 FlowScene::
 nodes() const
@@ -593,6 +922,220 @@ loadFromMemory(const QByteArray& data)
 }
 
 
+namespace
+{
+// "QNSB", followed by the version of the format
+const quint32 BINARY_MAGIC   = 0x514E5342;
+const quint32 BINARY_VERSION = 1;
+const QDataStream::Version BINARY_STREAM_VERSION = QDataStream::Qt_5_6;
+}
+
+
+QByteArray
+FlowScene::
+saveToBinary() const
+{
+  std::vector<const Node*> sortedNodes;
+  sortedNodes.reserve(_nodes.size());
+
+  for (auto const & pair : _nodes)
+  {
+    if (pair.second)
+    {
+      sortedNodes.push_back(pair.second.get());
+    }
+  }
+  std::sort(sortedNodes.begin(), sortedNodes.end(),
+            [](const Node* a, const Node* b) { return a->id() < b->id(); });
+
+  std::vector<QByteArray> nodesData;
+  nodesData.reserve(sortedNodes.size());
+
+  for (const Node* node : sortedNodes)
+  {
+    nodesData.push_back(saveNodeToBinary(*node));
+  }
+  return joinNodesToBinary(layout(), nodesData);
+}
+
+
+void
+FlowScene::
+loadFromBinary(const QByteArray& data)
+{
+  QDataStream in(data);
+  in.setVersion(BINARY_STREAM_VERSION);
+
+  quint32 magic = 0;
+  quint32 version = 0;
+  qint32 layoutValue = 0;
+  quint32 count = 0;
+  in >> magic >> version >> layoutValue >> count;
+
+  if (magic != BINARY_MAGIC || version != BINARY_VERSION)
+  {
+    throw std::runtime_error("[FlowScene::loadFromBinary] unknown format");
+  }
+
+  setLayout(static_cast<PortLayout>(layoutValue));
+
+  // nodes first, they are needed to restore the connections
+  std::vector<QJsonObject> connectionsJson;
+
+  for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++)
+  {
+    QByteArray nodeData;
+    in >> nodeData;
+
+    QJsonObject nodeJson;
+    std::vector<QJsonObject> nodeConnections;
+    if (!readNodeFromBinary(nodeData, nodeJson, nodeConnections))
+    {
+      throw std::runtime_error("[FlowScene::loadFromBinary] invalid node");
+    }
+    restoreNode(nodeJson);
+    connectionsJson.insert(connectionsJson.end(),
+                           nodeConnections.begin(), nodeConnections.end());
+  }
+
+  for (const auto& connection : connectionsJson)
+  {
+    restoreConnection(connection);
+  }
+}
+
+
+QByteArray
+FlowScene::
+saveNodeToBinary(const Node& node)
+{
+  QByteArray data;
+  QDataStream out(&data, QIODevice::WriteOnly);
+  out.setVersion(BINARY_STREAM_VERSION);
+
+  // same as Node::save(), without the conversion to JSON
+  const double width = node.nodeGeometry().boundingRect().width();
+  const QPointF pos = node.position();
+
+  out << node.id()
+      << pos.x() + width*0.5
+      << pos.y()
+      << node.nodeDataModel()->save().toVariantMap();
+
+  std::vector<const Connection*> connections;
+  for (const auto& entries : node.nodeState().getEntries(PortType::In))
+  {
+    for (const auto& pair : entries)
+    {
+      if (pair.second->getNode(PortType::Out))
+      {
+        connections.push_back(pair.second);
+      }
+    }
+  }
+  std::sort(connections.begin(), connections.end(),
+            [](const Connection* a, const Connection* b)
+  {
+    return std::make_tuple(a->getPortIndex(PortType::In),
+                           a->getNode(PortType::Out)->id(),
+                           a->getPortIndex(PortType::Out)) <
+           std::make_tuple(b->getPortIndex(PortType::In),
+                           b->getNode(PortType::Out)->id(),
+                           b->getPortIndex(PortType::Out));
+  });
+
+  out << quint32(connections.size());
+  for (const Connection* connection : connections)
+  {
+    const QJsonObject connectionJson = connection->save();
+
+    out << qint32(connection->getPortIndex(PortType::In))
+        << connection->getNode(PortType::Out)->id()
+        << qint32(connection->getPortIndex(PortType::Out))
+        << connectionJson["converter"].toObject().toVariantMap();
+  }
+  return data;
+}
+
+
+QByteArray
+FlowScene::
+joinNodesToBinary(PortLayout layout, const std::vector<QByteArray>& nodes)
+{
+  QByteArray data;
+  QDataStream out(&data, QIODevice::WriteOnly);
+  out.setVersion(BINARY_STREAM_VERSION);
+
+  out << BINARY_MAGIC << BINARY_VERSION
+      << qint32(layout) << quint32(nodes.size());
+
+  for (const QByteArray& nodeData : nodes)
+  {
+    out << nodeData;
+  }
+  return data;
+}
+
+
+bool
+FlowScene::
+readNodeFromBinary(const QByteArray& data,
+                   QJsonObject& nodeJson,
+                   std::vector<QJsonObject>& connectionsJson)
+{
+  QDataStream in(data);
+  in.setVersion(BINARY_STREAM_VERSION);
+
+  QUuid id;
+  double x = 0;
+  double y = 0;
+  QVariantMap model;
+  quint32 count = 0;
+  in >> id >> x >> y >> model >> count;
+
+  if (in.status() != QDataStream::Ok)
+  {
+    return false;
+  }
+
+  QJsonObject position;
+  position["x"] = x;
+  position["y"] = y;
+
+  nodeJson = QJsonObject();
+  nodeJson["id"] = id.toString();
+  nodeJson["model"] = QJsonObject::fromVariantMap(model);
+  nodeJson["position"] = position;
+
+  connectionsJson.clear();
+  for (quint32 i = 0; i < count; i++)
+  {
+    qint32 inIndex = 0;
+    QUuid outId;
+    qint32 outIndex = 0;
+    QVariantMap converter;
+    in >> inIndex >> outId >> outIndex >> converter;
+
+    if (in.status() != QDataStream::Ok)
+    {
+      return false;
+    }
+
+    QJsonObject connectionJson;
+    connectionJson["in_id"] = nodeJson["id"];
+    connectionJson["in_index"] = inIndex;
+    connectionJson["out_id"] = outId.toString();
+    connectionJson["out_index"] = outIndex;
+    if (!converter.isEmpty())
+    {
+      connectionJson["converter"] = QJsonObject::fromVariantMap(converter);
+    }
+    connectionsJson.push_back(connectionJson);
+  }
+  return true;
+}
+
+
 void FlowScene::setLayout( QtNodes::PortLayout layout)
 {
   _layout = layout;
@@ -611,6 +1154,222 @@ QtNodes::PortLayout FlowScene::layout() const
   return _layout;
 }
 
+
+QtNodes::DetailLevel
+FlowScene::
+detailLevel() const
+{
+  return _detailLevel;
+}
+
+
+void
+FlowScene::
+setDetailLevel(DetailLevel level)
+{
+  if (_detailLevel == level)
+    return;
+
+  _detailLevel = level;
+
+  for (auto const & node : _nodes)
+  {
+    if (node.second->hasGraphicsObject())
+      node.second->nodeGraphicsObject().updateDetailLevel();
+  }
+  for (auto const & connection : _connections)
+  {
+    if (connection.second->hasGraphicsObject())
+      connection.second->connectionGraphicsObject().update();
+  }
+  if (_placeholders)
+    _placeholders->update();
+}
+
+
+quint64
+FlowScene::
+revision() const
+{
+  return _revision;
+}
+
+
+void
+FlowScene::
+touch()
+{
+  ++_revision;
+  _touch_log.clear();
+  _touch_log_begin = _revision;
+}
+
+
+void
+FlowScene::
+touch(const Node& node)
+{
+  // enough for the edits between two reads of the tree
+  std::size_t const touchLogSize = 4096;
+
+  _touched_nodes.insert(node.id());
+  ++_revision;
+
+  // moved, resized, created or removed: the area of the placeholders changes
+  if (_placeholders && !node.hasGraphicsObject())
+    _placeholders->geometryChanged();
+
+  _touch_log.emplace_back(_revision, node.id());
+  if (_touch_log.size() > touchLogSize)
+  {
+    _touch_log_begin = _touch_log.front().first;
+    _touch_log.pop_front();
+  }
+}
+
+
+bool
+FlowScene::
+touchedNodesSince(quint64 revision, std::set<QUuid>& nodes) const
+{
+  if (revision < _touch_log_begin)
+    return false;
+
+  for (auto it = _touch_log.rbegin(); it != _touch_log.rend() && it->first > revision; ++it)
+    nodes.insert(it->second);
+
+  return true;
+}
+
+
+quint64
+FlowScene::
+topologyRevision() const
+{
+  return _topology_revision;
+}
+
+
+std::set<QUuid>
+FlowScene::
+takeTouchedNodes()
+{
+  std::set<QUuid> nodes;
+  nodes.swap(_touched_nodes);
+  return nodes;
+}
+
+
+void
+FlowScene::
+beginBatch()
+{
+  _batch_depth++;
+}
+
+
+void
+FlowScene::
+commitBatch()
+{
+  if (_batch_depth == 0)
+    return;
+
+  if (_batch_depth > 1)
+  {
+    _batch_depth--;
+    return;
+  }
+
+  // still in the batch: the handlers might create more nodes or connections
+  while (!_batch_created_nodes.empty() || !_batch_created_connections.empty())
+  {
+    std::vector<QUuid> created_nodes;
+    std::vector<QUuid> created_connections;
+    created_nodes.swap(_batch_created_nodes);
+    created_connections.swap(_batch_created_connections);
+
+    for (const auto& id : created_nodes)
+    {
+      auto it = _nodes.find(id);
+      if (it != _nodes.end())
+        nodeCreated(*it->second);
+    }
+
+    for (const auto& id : created_connections)
+    {
+      auto it = _connections.find(id);
+      if (it != _connections.end())
+        connectionCreated(*it->second);
+    }
+  }
+
+  _batch_depth = 0;
+
+  // a connection attached to two moved nodes is moved once
+  std::set<Connection*> moved_connections;
+  for (const auto& id : _batch_moved_nodes)
+  {
+    auto it = _nodes.find(id);
+    if (it == _nodes.end())
+      continue;
+
+    for (PortType portType : {PortType::In, PortType::Out})
+    {
+      for (auto const & connections : it->second->nodeState().getEntries(portType))
+      {
+        for (auto const & con : connections)
+          moved_connections.insert(con.second);
+      }
+    }
+  }
+  _batch_moved_nodes.clear();
+
+  for (auto connection : moved_connections)
+  {
+    if (connection->hasGraphicsObject())
+      connection->connectionGraphicsObject().move();
+  }
+
+  batchCommitted();
+}
+
+
+void
+FlowScene::
+abandonBatch()
+{
+  if (_batch_depth == 0)
+    return;
+
+  if (--_batch_depth > 0)
+    return;
+
+  _batch_created_nodes.clear();
+  _batch_created_connections.clear();
+  _batch_moved_nodes.clear();
+}
+
+
+bool
+FlowScene::
+inBatch() const
+{
+  return _batch_depth > 0;
+}
+
+
+bool
+FlowScene::
+deferMoveConnections(const Node& node)
+{
+  if (!inBatch())
+    return false;
+
+  _batch_moved_nodes.insert(node.id());
+  return true;
+}
+
 //------------------------------------------------------------------------------
 namespace QtNodes
 {
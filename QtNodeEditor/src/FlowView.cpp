@@ -11,6 +11,12 @@
 
 #include <QtWidgets>
 
+#ifndef QT_NO_OPENGL
+#include <QtWidgets/QOpenGLWidget>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QSurfaceFormat>
+#endif
+
 #include <QDebug>
 #include <iostream>
 #include <cmath>
@@ -24,6 +30,9 @@
 
 using QtNodes::FlowView;
 using QtNodes::FlowScene;
+using QtNodes::DetailLevel;
+
+static bool openGLByDefault = false;
 
 FlowView::
 FlowView(QWidget *parent)
@@ -39,8 +48,8 @@ FlowView(QWidget *parent)
 
   setBackgroundBrush(flowViewStyle.BackgroundColor);
 
-  setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
-  //setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+  // the nodes repaint only the regions they dirty, e.g. on status changes
+  setViewportUpdateMode(QGraphicsView::SmartViewportUpdate);
 
   setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
   setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
@@ -49,7 +58,8 @@ FlowView(QWidget *parent)
 
   setCacheMode(QGraphicsView::CacheBackground);
 
-  //setViewport(new QGLWidget(QGLFormat(QGL::SampleBuffers)));
+  if (openGLByDefault)
+    setOpenGLViewport(true);
 }
 
 
@@ -82,6 +92,7 @@ FlowView::setScene(FlowScene *scene)
 {
   _scene = scene;
   QGraphicsView::setScene(_scene);
+  updateDetailLevel();
 
   // setup actions
   delete _clearSelectionAction;
@@ -98,6 +109,68 @@ FlowView::setScene(FlowScene *scene)
 }
 
 
+bool
+FlowView::
+setOpenGLViewport(bool enabled, int samples)
+{
+  if (enabled == isOpenGLViewport())
+    return true;
+
+  if (!enabled)
+  {
+    setViewport(new QWidget);
+    setViewportUpdateMode(QGraphicsView::SmartViewportUpdate);
+    return true;
+  }
+
+#ifndef QT_NO_OPENGL
+  QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+  format.setSamples(samples);
+
+  // any implementation will do, Mesa's software rasterizer included
+  QOpenGLContext context;
+  context.setFormat(format);
+  if (!context.create())
+  {
+    qWarning() << "OpenGL is not available, the raster viewport is used";
+    return false;
+  }
+
+  auto glWidget = new QOpenGLWidget;
+  glWidget->setFormat(format);
+  setViewport(glWidget);
+
+  // the framebuffer is not preserved between frames
+  setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+  return true;
+#else
+  Q_UNUSED(samples);
+  qWarning() << "Qt was built without OpenGL, the raster viewport is used";
+  return false;
+#endif
+}
+
+
+bool
+FlowView::
+isOpenGLViewport() const
+{
+#ifndef QT_NO_OPENGL
+  return qobject_cast<QOpenGLWidget*>(viewport()) != nullptr;
+#else
+  return false;
+#endif
+}
+
+
+void
+FlowView::
+setOpenGLByDefault(bool enabled)
+{
+  openGLByDefault = enabled;
+}
+
+
 void
 FlowView::
 contextMenuEvent(QContextMenuEvent *event)
@@ -404,6 +477,86 @@ showEvent(QShowEvent *event)
 }
 
 
+DetailLevel
+FlowView::
+detailLevel() const
+{
+  // below these zoom levels labels and widgets are unreadable anyway
+  double const simplifiedBelow = 0.45;
+  double const schematicBelow  = 0.2;
+
+  double const zoom = transform().m11();
+
+  if (zoom < schematicBelow)
+    return DetailLevel::Schematic;
+
+  if (zoom < simplifiedBelow)
+    return DetailLevel::Simplified;
+
+  return DetailLevel::Full;
+}
+
+
+void
+FlowView::
+scale(qreal sx, qreal sy)
+{
+  QGraphicsView::scale(sx, sy);
+  updateDetailLevel();
+}
+
+
+void
+FlowView::
+setTransform(const QTransform &matrix, bool combine)
+{
+  QGraphicsView::setTransform(matrix, combine);
+  updateDetailLevel();
+}
+
+
+void
+FlowView::
+resetTransform()
+{
+  QGraphicsView::resetTransform();
+  updateDetailLevel();
+}
+
+
+void
+FlowView::
+fitInView(const QRectF &rect, Qt::AspectRatioMode aspectRatioMode)
+{
+  QGraphicsView::fitInView(rect, aspectRatioMode);
+  updateDetailLevel();
+}
+
+
+void
+FlowView::
+updateDetailLevel()
+{
+  if (_scene)
+    _scene->setDetailLevel(detailLevel());
+}
+
+
+void
+FlowView::
+paintEvent(QPaintEvent *event)
+{
+  QRectF const visibleArea = mapToScene(viewport()->rect()).boundingRect();
+  if (visibleArea != _visibleArea)
+  {
+    _visibleArea = visibleArea;
+    emit visibleAreaChanged();
+  }
+
+  QGraphicsView::paintEvent(event);
+}
+
+
 FlowScene *
 FlowView::
 scene()
@@ -24,8 +24,10 @@ using QtNodes::PortIndex;
 using QtNodes::PortType;
 
 Node::
-Node(std::unique_ptr<NodeDataModel> && dataModel)
+Node(std::unique_ptr<NodeDataModel> && dataModel,
+     FlowScene& scene)
   : _uid(QUuid::createUuid())
+  , _scene(scene)
   , _nodeDataModel(std::move(dataModel))
   , _nodeState(_nodeDataModel)
   , _nodeGeometry(_nodeDataModel)
@@ -39,6 +41,9 @@ Node(std::unique_ptr<NodeDataModel> && dataModel)
 
   connect(_nodeDataModel.get(), &NodeDataModel::embeddedWidgetSizeUpdated,
           this, &Node::onNodeSizeUpdated );
+
+  connect(_nodeDataModel.get(), &NodeDataModel::embeddedWidgetReplaced,
+          this, &Node::onEmbeddedWidgetReplaced );
 }
 
 
@@ -55,11 +60,12 @@ save() const
 
   nodeJson["model"] = _nodeDataModel->save();
 
-  double width = _nodeGraphicsObject->boundingRect().width();
+  double width = _nodeGeometry.boundingRect().width();
+  QPointF const pos = position();
 
   QJsonObject obj;
-  obj["x"] = _nodeGraphicsObject->pos().x() + width*0.5;
-  obj["y"] = _nodeGraphicsObject->pos().y();
+  obj["x"] = pos.x() + width*0.5;
+  obj["y"] = pos.y();
   nodeJson["position"] = obj;
 
   return nodeJson;
@@ -73,12 +79,12 @@ restore(QJsonObject const& json)
   _uid = QUuid(json["id"].toString());
   _nodeDataModel->restore(json["model"].toObject());
 
-  double width = _nodeGraphicsObject->boundingRect().width();
+  double width = _nodeGeometry.boundingRect().width();
 
   QJsonObject positionJson = json["position"].toObject();
   QPointF     point(positionJson["x"].toDouble() - width*0.5,
                     positionJson["y"].toDouble());
-  _nodeGraphicsObject->setPos(point);
+  setPosition(point);
 
 }
 
@@ -97,13 +103,13 @@ reactToPossibleConnection(PortType reactingPortType,
                           NodeDataType const &reactingDataType,
                           QPointF const &scenePoint)
 {
-  QTransform const t = _nodeGraphicsObject->sceneTransform();
+  QTransform const t = sceneTransform();
 
   QPointF p = t.inverted().map(scenePoint);
 
   _nodeGeometry.setDraggingPosition(p);
 
-  _nodeGraphicsObject->update();
+  _scene.updateNode(*this);
 
   _nodeState.setReaction(NodeState::REACTING,
                          reactingPortType,
@@ -116,7 +122,15 @@ Node::
 resetReactionToConnection()
 {
   _nodeState.setReaction(NodeState::NOT_REACTING);
-  _nodeGraphicsObject->update();
+  _scene.updateNode(*this);
+}
+
+
+QtNodes::FlowScene &
+Node::
+flowScene() const
+{
+  return _scene;
 }
 
 
@@ -124,6 +138,9 @@ NodeGraphicsObject const &
 Node::
 nodeGraphicsObject() const
 {
+  if (!_nodeGraphicsObject)
+    _scene.createNodeGraphics(const_cast<Node&>(*this));
+
   return *_nodeGraphicsObject.get();
 }
 
@@ -132,10 +149,21 @@ NodeGraphicsObject &
 Node::
 nodeGraphicsObject()
 {
+  if (!_nodeGraphicsObject)
+    _scene.createNodeGraphics(*this);
+
   return *_nodeGraphicsObject.get();
 }
 
 
+bool
+Node::
+hasGraphicsObject() const
+{
+  return _nodeGraphicsObject != nullptr;
+}
+
+
 void
 Node::
 setGraphicsObject(std::unique_ptr<NodeGraphicsObject>&& graphics)
@@ -146,6 +174,60 @@ setGraphicsObject(std::unique_ptr<NodeGraphicsObject>&& graphics)
 }
 
 
+void
+Node::
+releaseGraphicsObject()
+{
+  if (!_nodeGraphicsObject)
+    return;
+
+  _pos = _nodeGraphicsObject->pos();
+  _nodeGraphicsObject->detachEmbeddedWidget();
+  _nodeGraphicsObject.reset();
+
+  _nodeGeometry.setHovered(false);
+}
+
+
+QPointF
+Node::
+position() const
+{
+  if (_nodeGraphicsObject)
+    return _nodeGraphicsObject->pos();
+
+  return _pos;
+}
+
+
+void
+Node::
+setPosition(QPointF const& pos)
+{
+  if (_nodeGraphicsObject)
+  {
+    _nodeGraphicsObject->setPos(pos);
+    return;
+  }
+
+  // as NodeGraphicsObject::itemChange() does
+  _pos = pos;
+  _scene.touch(*this);
+  _scene.moveNodeConnections(*this);
+}
+
+
+QTransform
+Node::
+sceneTransform() const
+{
+  if (_nodeGraphicsObject)
+    return _nodeGraphicsObject->sceneTransform();
+
+  return QTransform::fromTranslate(_pos.x(), _pos.y());
+}
+
+
 NodeGeometry&
 Node::
 nodeGeometry()
@@ -186,6 +268,19 @@ nodeDataModel() const
 }
 
 
+std::unique_ptr<NodeDataModel>
+Node::
+releaseDataModel()
+{
+  if (_nodeGraphicsObject)
+    _nodeGraphicsObject->detachEmbeddedWidget();
+
+  disconnect(_nodeDataModel.get(), nullptr, this, nullptr);
+
+  return std::move(_nodeDataModel);
+}
+
+
 void
 Node::
 propagateData(std::shared_ptr<NodeData> nodeData,
@@ -194,10 +289,13 @@ propagateData(std::shared_ptr<NodeData> nodeData,
   _nodeDataModel->setInData(std::move(nodeData), inPortIndex);
 
   //Recalculate the nodes visuals. A data change can result in the node taking more space than before, so this forces a recalculate+repaint on the affected node
-  _nodeGraphicsObject->setGeometryChanged();
+  if (_nodeGraphicsObject)
+    _nodeGraphicsObject->setGeometryChanged();
+  else
+    _scene.touch(*this);
   _nodeGeometry.recalculateSize();
-  _nodeGraphicsObject->update();
-  _nodeGraphicsObject->moveConnections();
+  _scene.updateNode(*this);
+  _scene.moveNodeConnections(*this);
 }
 
 
@@ -223,25 +321,37 @@ onNodeSizeUpdated()
     {
         nodeDataModel()->embeddedWidget()->adjustSize();
     }
+    // the bounding rect might change, and the content painted
+    // without a widget too
+    if( _nodeGraphicsObject )
+    {
+        _nodeGraphicsObject->setGeometryChanged();
+    }
+    else
+    {
+        _scene.touch(*this);
+    }
     nodeGeometry().recalculateSize();
+    _scene.updateNode(*this);
     int new_width = nodeGeometry().width();
 
     if( new_width != prev_width )
     {
-        auto node_pos = nodeGraphicsObject().pos();
+        auto node_pos = position();
         node_pos.setX( node_pos.x() - (new_width - prev_width)*0.5);
-        nodeGraphicsObject().setPos(node_pos);
+        setPosition(node_pos);
     }
 
-    for(PortType type: {PortType::In, PortType::Out})
-    {
-        for(auto& conn_set : nodeState().getEntries(type))
-        {
-            for(auto& pair: conn_set)
-            {
-                Connection* conn = pair.second;
-                conn->connectionGraphicsObject().move();
-            }
-        }
-    }
+    _scene.moveNodeConnections(*this);
+}
+
+void
+Node::
+onEmbeddedWidgetReplaced()
+{
+  if (!_nodeGraphicsObject)
+    return;
+
+  _nodeGraphicsObject->updateEmbeddedQWidget();
+  onNodeSizeUpdated();
 }
@@ -123,6 +123,8 @@ tryConnect() const
 
   _node->nodeGraphicsObject().moveConnections();
 
+  touchConnectedNodes();
+
   // 5) Poke model to intiate data transfer
 
   auto outNode = _connection->getNode(PortType::Out);
@@ -157,8 +159,13 @@ disconnect(PortType portToDisconnect) const
   // clear Connection side
   _connection->clearNode(portToDisconnect);
 
+  _scene->touch(*_node);
+  _scene->updateTopology(*_node);
+
   _connection->setRequiredPort(portToDisconnect);
 
+  touchConnectedNodes();
+
   _connection->connectionGraphicsObject().grabMouse();
 
   return true;
@@ -236,3 +243,19 @@ nodePortIsEmpty(PortType portType, PortIndex portIndex) const
   const auto outPolicy = _node->nodeDataModel()->portOutConnectionPolicy(portIndex);
   return ( portType == PortType::Out && outPolicy == NodeDataModel::ConnectionPolicy::Many);
 }
+
+
+void
+NodeConnectionInteraction::
+touchConnectedNodes() const
+{
+  for (auto portType: {PortType::In, PortType::Out})
+  {
+    if (auto node = _connection->getNode(portType))
+    {
+      _scene->touch(*node);
+      if (portType == PortType::In)
+        _scene->updateTopology(*node);
+    }
+  }
+}
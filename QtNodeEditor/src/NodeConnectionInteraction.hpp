@@ -57,6 +57,10 @@ private:
 
   bool nodePortIsEmpty(PortType portType, PortIndex portIndex) const;
 
+  /// Tell the scene that the nodes at both ends of the connection changed,
+  /// including the parent of the node at its input end
+  void touchConnectedNodes() const;
+
 private:
 
   Node* _node;
@@ -38,3 +38,11 @@ setNodeStyle(NodeStyle const& style)
 {
   _nodeStyle = style;
 }
+
+
+void
+NodeDataModel::
+resetNodeStyle()
+{
+  _nodeStyle = StyleCollection::nodeStyle();
+}
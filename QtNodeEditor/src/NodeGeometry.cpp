@@ -30,8 +30,10 @@ NodeGeometry(std::unique_ptr<NodeDataModel> const &dataModel)
   , _hovered(false)
   , _draggingPos(-1000, -1000)
   , _dataModel(dataModel)
-  , _fontMetrics(QFont())
-  , _boldFontMetrics(QFont())
+  , _font()
+  , _fontMetrics(_font)
+  , _boldFontMetrics(_font)
+  , _dirty(true)
   , _ports_layout(PortLayout::Vertical  )
 {
   QFont f;
@@ -91,10 +93,9 @@ recalculateSize() const
     _height = step * maxNumOfEntries;
   }
 
-  if (auto w = _dataModel->embeddedWidget())
-  {
-    _height = std::max(_height, w->height());
-  }
+  QSize const content = contentSize();
+
+  _height = std::max(_height, content.height());
 
   _inputPortWidth  = portWidth(PortType::In);
   _outputPortWidth = portWidth(PortType::Out);
@@ -103,16 +104,15 @@ recalculateSize() const
            _outputPortWidth +
            2 * _spacing;
 
-  if (auto w = _dataModel->embeddedWidget())
-  {
-    _width += w->width();
-  }
+  _width += content.width();
 
   if (_dataModel->validationState() != NodeValidationState::Valid)
   {
     _width   = std::max(_width, (int)validationWidth());
     _height += validationHeight() + _spacing;
   }
+
+  _dirty = false;
 }
 
 
@@ -120,18 +120,20 @@ void
 NodeGeometry::
 recalculateSize(QFont const & font) const
 {
-  QFontMetrics fontMetrics(font);
-  QFont boldFont = font;
-  boldFont.setPointSize(12);
+  // the metrics are built only for a different font
+  if (font != _font)
+  {
+    QFont boldFont = font;
+    boldFont.setPointSize(12);
 
-  QFontMetrics boldFontMetrics(boldFont);
+    _font            = font;
+    _fontMetrics     = QFontMetrics(font);
+    _boldFontMetrics = QFontMetrics(boldFont);
+    _dirty = true;
+  }
 
-  if (_boldFontMetrics != boldFontMetrics)
-  {
-    _fontMetrics     = fontMetrics;
-    _boldFontMetrics = boldFontMetrics;
+  if (_dirty)
     recalculateSize();
-  }
 }
 
 
@@ -218,21 +220,37 @@ QPointF
 NodeGeometry::
 widgetPosition() const
 {
-  if (auto w = _dataModel->embeddedWidget())
+  if (_dataModel->embeddedWidget() || _dataModel->painterDelegate())
   {
+    int const contentHeight = contentSize().height();
+
     if (_dataModel->validationState() != NodeValidationState::Valid)
     {
-      return QPointF(_spacing + portWidth(PortType::In),
-                     ( _height - validationHeight() - _spacing - w->height()) / 2.0);
+      return QPointF(_spacing + _inputPortWidth,
+                     ( _height - validationHeight() - _spacing - contentHeight) / 2.0);
     }
 
-    return QPointF(_spacing + portWidth(PortType::In),
-                   ( _height - w->height()) / 2.0);
+    return QPointF(_spacing + _inputPortWidth,
+                   ( _height - contentHeight) / 2.0);
   }
 
   return QPointF();
 }
 
+
+QSize
+NodeGeometry::
+contentSize() const
+{
+  if (auto w = _dataModel->embeddedWidget())
+    return w->size();
+
+  if (auto delegate = _dataModel->painterDelegate())
+    return delegate->size(_dataModel.get());
+
+  return QSize();
+}
+
 unsigned int
 NodeGeometry::
 validationHeight() const
@@ -261,8 +279,8 @@ calculateNodePositionBetweenNodePorts(PortIndex targetPortIndex, PortType target
   //The first line calculates the halfway point between the ports (node position + port position on the node for both nodes averaged).
   //The second line offsets this coordinate with the size of the new node, so that the new nodes center falls on the originally
   //calculated coordinate, instead of it's upper left corner.
-  auto converterNodePos = (sourceNode->nodeGraphicsObject().pos() + sourceNode->nodeGeometry().portScenePosition(sourcePortIndex, sourcePort) +
-    targetNode->nodeGraphicsObject().pos() + targetNode->nodeGeometry().portScenePosition(targetPortIndex, targetPort)) / 2.0f;
+  auto converterNodePos = (sourceNode->position() + sourceNode->nodeGeometry().portScenePosition(sourcePortIndex, sourcePort) +
+    targetNode->position() + targetNode->nodeGeometry().portScenePosition(targetPortIndex, targetPort)) / 2.0f;
   converterNodePos.setX(converterNodePos.x() - newNode.nodeGeometry().width() / 2.0f);
   converterNodePos.setY(converterNodePos.y() - newNode.nodeGeometry().height() / 2.0f);
   return converterNodePos;
@@ -270,7 +288,11 @@ calculateNodePositionBetweenNodePorts(PortIndex targetPortIndex, PortType target
 
 void NodeGeometry::setPortLayout(QtNodes::PortLayout layout)
 {
-    _ports_layout = layout;
+    if( _ports_layout != layout )
+    {
+        _ports_layout = layout;
+        _dirty = true;
+    }
 }
 
 
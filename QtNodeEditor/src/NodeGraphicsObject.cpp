@@ -4,7 +4,6 @@
 #include <cstdlib>
 
 #include <QtWidgets/QtWidgets>
-#include <QtWidgets/QGraphicsEffect>
 
 #include "ConnectionGraphicsObject.hpp"
 #include "ConnectionState.hpp"
@@ -21,6 +20,7 @@
 using QtNodes::NodeGraphicsObject;
 using QtNodes::Node;
 using QtNodes::FlowScene;
+using QtNodes::DetailLevel;
 
 NodeGraphicsObject::
 NodeGraphicsObject(FlowScene &scene,
@@ -31,6 +31,10 @@ NodeGraphicsObject(FlowScene &scene,
   , _double_clicked(false)
   , _proxyWidget(nullptr)
 {
+  // where the node was without a graphics object, before entering the
+  // scene, which would be told about a move otherwise
+  setPos(node.position());
+
   _scene.addItem(this);
 
   setFlag(QGraphicsItem::ItemDoesntPropagateOpacityToChildren, true);
@@ -43,15 +47,8 @@ NodeGraphicsObject(FlowScene &scene,
 
   auto const &nodeStyle = node.nodeDataModel()->nodeStyle();
 
-  {
-    auto effect = new QGraphicsDropShadowEffect;
-    effect->setOffset(2, 2);
-    effect->setBlurRadius(5);
-    effect->setColor(nodeStyle.ShadowColor);
-
-    setGraphicsEffect(effect);
-  }
-
+  // the shadow is drawn by NodePainter: a graphics effect would
+  // render and blur the node offscreen at every update
   setOpacity(nodeStyle.Opacity);
 
   setAcceptHoverEvents(true);
@@ -59,7 +56,6 @@ NodeGraphicsObject(FlowScene &scene,
   setZValue(0);
 
   updateEmbeddedQWidget();
-
 }
 
 
@@ -93,8 +89,11 @@ updateEmbeddedQWidget()
 
   if( _proxyWidget )
   {
+    // the widget belongs to the model, it might be embedded again
+    detachEmbeddedWidget();
     _scene.removeItem(_proxyWidget);
     _proxyWidget->deleteLater();
+    _proxyWidget = nullptr;
   }
 
   if (auto w = _node.nodeDataModel()->embeddedWidget())
@@ -103,6 +102,10 @@ updateEmbeddedQWidget()
 
     _proxyWidget->setWidget(w);
 
+    // a recycled widget, hidden by detachEmbeddedWidget()
+    if (w->isHidden())
+      w->show();
+
     _proxyWidget->setPreferredWidth(5);
 
     geom.recalculateSize();
@@ -114,6 +117,37 @@ updateEmbeddedQWidget()
     _proxyWidget->setOpacity(1.0);
     _proxyWidget->setFlag(QGraphicsItem::ItemIgnoresParentOpacity);
   }
+
+  updateDetailLevel();
+}
+
+
+void
+NodeGraphicsObject::
+detachEmbeddedWidget()
+{
+  if (!_proxyWidget)
+    return;
+
+  if (auto w = _proxyWidget->widget())
+  {
+    // out of the scene, it must not become a window
+    w->hide();
+    _proxyWidget->setWidget(nullptr);
+  }
+}
+
+
+void
+NodeGraphicsObject::
+updateDetailLevel()
+{
+  bool const full = (_scene.detailLevel() == DetailLevel::Full);
+
+  if (_proxyWidget)
+    _proxyWidget->setVisible(full);
+
+  update();
 }
 
 
@@ -130,6 +164,7 @@ NodeGraphicsObject::
 setGeometryChanged()
 {
   prepareGeometryChange();
+  _scene.touch(_node);
 }
 
 
@@ -137,19 +172,7 @@ void
 NodeGraphicsObject::
 moveConnections() const
 {
-  NodeState const & nodeState = _node.nodeState();
-
-  for(PortType portType: {PortType::In, PortType::Out})
-  {
-    auto const & connectionEntries =
-        nodeState.getEntries(portType);
-
-    for (auto const & connections : connectionEntries)
-    {
-      for (auto & con : connections)
-        con.second->connectionGraphicsObject().move();
-    }
-  };
+  _scene.moveNodeConnections(_node);
 }
 
 void NodeGraphicsObject::lock(bool locked)
@@ -180,6 +203,7 @@ itemChange(GraphicsItemChange change, const QVariant &value)
   if (change == ItemPositionChange && scene())
   {
     moveConnections();
+    _scene.touch(_node);
   }
 
   return QGraphicsItem::itemChange(change, value);
@@ -413,7 +437,7 @@ mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event)
 {
   QGraphicsItem::mouseDoubleClickEvent(event);
   _double_clicked = true;
-  emit _scene.nodeDoubleClicked(node());
+  emit _scene.nodeDoubleClicked(node(), event->scenePos());
 }
 
 void
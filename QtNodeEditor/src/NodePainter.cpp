@@ -1,8 +1,12 @@
 #include "NodePainter.hpp"
 
 #include <cmath>
+#include <vector>
 
 #include <QtCore/QMargins>
+#include <QtGui/QImage>
+#include <QtGui/QPixmapCache>
+#include <QtWidgets/qdrawutil.h>
 
 #include "StyleCollection.hpp"
 #include "PortType.hpp"
@@ -21,6 +25,7 @@ using QtNodes::Node;
 using QtNodes::NodeState;
 using QtNodes::NodeDataModel;
 using QtNodes::FlowScene;
+using QtNodes::DetailLevel;
 
 void
 NodePainter::
@@ -32,14 +37,33 @@ paint(QPainter* painter,
 
   NodeState const& state = node.nodeState();
 
-  NodeGraphicsObject const & graphicsObject = node.nodeGraphicsObject();
+  // painted without a graphics object too, see FlowScene::setGraphicsOnDemand()
+  bool const selected = node.hasGraphicsObject() &&
+                        node.nodeGraphicsObject().isSelected();
 
   geom.recalculateSize(painter->font());
 
   //--------------------------------------------
   NodeDataModel const * model = node.nodeDataModel();
 
-  drawNodeRect(painter, geom, model, graphicsObject);
+  switch (scene.detailLevel())
+  {
+    case DetailLevel::Schematic:
+      drawSchematicRect(painter, geom, model, selected);
+      return;
+
+    case DetailLevel::Simplified:
+      drawFlatNodeRect(painter, geom, model, selected);
+      drawFilledConnectionPoints(painter, geom, state, model);
+      return;
+
+    case DetailLevel::Full:
+      break;
+  }
+
+  drawShadow(painter, geom, model);
+
+  drawNodeRect(painter, geom, model, selected);
 
   drawConnectionPoints(painter, geom, state, model, scene);
 
@@ -49,7 +73,7 @@ paint(QPainter* painter,
 
   drawResizeRect(painter, geom, model);
 
-  drawValidationRect(painter, geom, model, graphicsObject);
+  drawValidationRect(painter, geom, model, selected);
 
   /// call custom painter
   if (auto painterDelegate = model->painterDelegate())
@@ -59,16 +83,177 @@ paint(QPainter* painter,
 }
 
 
+namespace
+{
+
+// drop shadow of the nodes, in pixels
+const int    shadowBlurRadius = 5;
+const QPoint shadowOffset(2, 2);
+const int    nodeCornerRadius = 3;
+
+// Gaussian blur of the alpha channel, in place
+void
+blurAlpha(QImage & image, int radius)
+{
+  double const sigma = radius / 2.0;
+
+  std::vector<double> kernel(2 * radius + 1);
+  double sum = 0.0;
+  for (int i = -radius; i <= radius; ++i)
+  {
+    kernel[i + radius] = std::exp(-(i * i) / (2.0 * sigma * sigma));
+    sum += kernel[i + radius];
+  }
+  for (auto & k : kernel)
+    k /= sum;
+
+  int const w = image.width();
+  int const h = image.height();
+
+  std::vector<double> alpha(w * h);
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x)
+      alpha[y * w + x] = qAlpha(image.pixel(x, y));
+
+  std::vector<double> tmp(w * h, 0.0);
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x)
+      for (int k = -radius; k <= radius; ++k)
+        tmp[y * w + x] += kernel[k + radius] * alpha[y * w + qBound(0, x + k, w - 1)];
+
+  QRgb const color = image.pixel(w / 2, h / 2);
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x)
+    {
+      double a = 0.0;
+      for (int k = -radius; k <= radius; ++k)
+        a += kernel[k + radius] * tmp[qBound(0, y + k, h - 1) * w + x];
+
+      image.setPixel(x, y, qRgba(qRed(color), qGreen(color), qBlue(color), qRound(a)));
+    }
+}
+
+}
+
+
+void
+NodePainter::
+drawShadow(QPainter* painter,
+           NodeGeometry const& geom,
+           NodeDataModel const* model)
+{
+  NodeStyle const& nodeStyle = model->nodeStyle();
+
+  QColor const color = nodeStyle.ShadowColor;
+
+  if (color.alpha() == 0)
+    return;
+
+  // the corners are as wide as the blur, plus the rounded corner
+  int const margin = 2 * shadowBlurRadius + nodeCornerRadius;
+
+  QString const key = QStringLiteral("QtNodes::shadow:%1").arg(color.rgba(), 0, 16);
+
+  QPixmap pixmap;
+  if (!QPixmapCache::find(key, &pixmap))
+  {
+    int const side = 2 * margin + 1;
+
+    QImage image(side, side, QImage::Format_ARGB32);
+    image.fill(Qt::transparent);
+    {
+      QPainter p(&image);
+      p.setRenderHint(QPainter::Antialiasing);
+      p.setPen(Qt::NoPen);
+      p.setBrush(QColor(color.red(), color.green(), color.blue()));
+      p.drawRoundedRect(QRectF(shadowBlurRadius, shadowBlurRadius,
+                               side - 2 * shadowBlurRadius,
+                               side - 2 * shadowBlurRadius),
+                        nodeCornerRadius, nodeCornerRadius);
+    }
+    blurAlpha(image, shadowBlurRadius);
+
+    pixmap = QPixmap::fromImage(image);
+    QPixmapCache::insert(key, pixmap);
+  }
+
+  int const diam = qRound(nodeStyle.ConnectionPointDiameter);
+
+  QRect target(-diam, -diam, 2 * diam + geom.width(), 2 * diam + geom.height());
+
+  target.translate(shadowOffset);
+  target.adjust(-shadowBlurRadius, -shadowBlurRadius,
+                shadowBlurRadius, shadowBlurRadius);
+
+  qreal const opacity = painter->opacity();
+  painter->setOpacity(opacity * color.alphaF());
+
+  QMargins const margins(margin, margin, margin, margin);
+  qDrawBorderPixmap(painter, target, margins, pixmap);
+
+  painter->setOpacity(opacity);
+}
+
+
+void
+NodePainter::
+drawFlatNodeRect(QPainter* painter,
+                 NodeGeometry const& geom,
+                 NodeDataModel const* model,
+                 bool selected)
+{
+  NodeStyle const& nodeStyle = model->nodeStyle();
+
+  auto color = selected
+               ? nodeStyle.SelectedBoundaryColor
+               : nodeStyle.NormalBoundaryColor;
+
+  painter->setPen(QPen(color, nodeStyle.PenWidth));
+  painter->setBrush(nodeStyle.GradientColor1);
+
+  float diam = nodeStyle.ConnectionPointDiameter;
+
+  QRectF boundary( -diam, -diam, 2.0 * diam + geom.width(), 2.0 * diam + geom.height());
+
+  painter->drawRect(boundary);
+}
+
+
+void
+NodePainter::
+drawSchematicRect(QPainter* painter,
+                  NodeGeometry const& geom,
+                  NodeDataModel const* model,
+                  bool selected)
+{
+  NodeStyle const& nodeStyle = model->nodeStyle();
+
+  QColor color = nodeStyle.GradientColor1;
+
+  if (selected)
+    color = nodeStyle.SelectedBoundaryColor;
+  else if (nodeStyle.NormalBoundaryColor != StyleCollection::nodeStyle().NormalBoundaryColor)
+    color = nodeStyle.NormalBoundaryColor;
+
+  float diam = nodeStyle.ConnectionPointDiameter;
+
+  QRectF boundary( -diam, -diam, 2.0 * diam + geom.width(), 2.0 * diam + geom.height());
+
+  painter->setRenderHint(QPainter::Antialiasing, false);
+  painter->fillRect(boundary, color);
+}
+
+
 void
 NodePainter::
 drawNodeRect(QPainter* painter,
              NodeGeometry const& geom,
              NodeDataModel const* model,
-             NodeGraphicsObject const & graphicsObject)
+             bool selected)
 {
   NodeStyle const& nodeStyle = model->nodeStyle();
 
-  auto color = graphicsObject.isSelected()
+  auto color = selected
                ? nodeStyle.SelectedBoundaryColor
                : nodeStyle.NormalBoundaryColor;
 
@@ -97,7 +282,7 @@ drawNodeRect(QPainter* painter,
 
   QRectF boundary( -diam, -diam, 2.0 * diam + geom.width(), 2.0 * diam + geom.height());
 
-  double const radius = 3.0;
+  double const radius = nodeCornerRadius;
 
   painter->drawRoundedRect(boundary, radius, radius);
 }
@@ -303,7 +488,7 @@ NodePainter::
 drawValidationRect(QPainter * painter,
                    NodeGeometry const & geom,
                    NodeDataModel const * model,
-                   NodeGraphicsObject const & graphicsObject)
+                   bool selected)
 {
   auto modelValidationState = model->validationState();
 
@@ -311,7 +496,7 @@ drawValidationRect(QPainter * painter,
   {
     NodeStyle const& nodeStyle = model->nodeStyle();
 
-    auto color = graphicsObject.isSelected()
+    auto color = selected
                  ? nodeStyle.SelectedBoundaryColor
                  : nodeStyle.NormalBoundaryColor;
 
@@ -27,12 +27,37 @@ public:
         Node& node,
         FlowScene const& scene);
 
+  /// Drop shadow of the node, stretched from a blurred nine-patch
+  /// pixmap shared by all the nodes with the same shadow color.
+  static
+  void
+  drawShadow(QPainter* painter,
+             NodeGeometry const& geom,
+             NodeDataModel const* model);
+
+  /// Flat body of the node, for the simplified detail level.
+  static
+  void
+  drawFlatNodeRect(QPainter* painter,
+                   NodeGeometry const& geom,
+                   NodeDataModel const* model,
+                   bool selected);
+
+  /// A single filled rect, in the colour of the status of the node
+  /// if it has one, for the schematic detail level.
+  static
+  void
+  drawSchematicRect(QPainter* painter,
+                    NodeGeometry const& geom,
+                    NodeDataModel const* model,
+                    bool selected);
+
   static
   void
   drawNodeRect(QPainter* painter,
                NodeGeometry const& geom,
                NodeDataModel const* model,
-               NodeGraphicsObject const & graphicsObject);
+               bool selected);
 
   static
   void
@@ -67,6 +92,6 @@ public:
   drawValidationRect(QPainter * painter,
                      NodeGeometry const & geom,
                      NodeDataModel const * model,
-                     NodeGraphicsObject const & graphicsObject);
+                     bool selected);
 };
 }
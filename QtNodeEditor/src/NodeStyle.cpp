@@ -134,3 +134,27 @@ loadJsonFromByteArray(QByteArray const &byteArray)
 
   NODE_STYLE_READ_FLOAT(obj, Opacity);
 }
+
+
+bool
+NodeStyle::
+operator==(NodeStyle const& other) const
+{
+  return NormalBoundaryColor        == other.NormalBoundaryColor &&
+         SelectedBoundaryColor      == other.SelectedBoundaryColor &&
+         GradientColor0             == other.GradientColor0 &&
+         GradientColor1             == other.GradientColor1 &&
+         GradientColor2             == other.GradientColor2 &&
+         GradientColor3             == other.GradientColor3 &&
+         ShadowColor                == other.ShadowColor &&
+         FontColor                  == other.FontColor &&
+         FontColorFaded             == other.FontColorFaded &&
+         ConnectionPointColor       == other.ConnectionPointColor &&
+         FilledConnectionPointColor == other.FilledConnectionPointColor &&
+         WarningColor               == other.WarningColor &&
+         ErrorColor                 == other.ErrorColor &&
+         PenWidth                   == other.PenWidth &&
+         HoveredPenWidth            == other.HoveredPenWidth &&
+         ConnectionPointDiameter    == other.ConnectionPointDiameter &&
+         Opacity                    == other.Opacity;
+}
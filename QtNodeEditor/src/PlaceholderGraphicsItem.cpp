@@ -0,0 +1,124 @@
+#include "PlaceholderGraphicsItem.hpp"
+
+#include <QtWidgets/QStyleOptionGraphicsItem>
+
+#include "FlowScene.hpp"
+#include "Node.hpp"
+#include "NodeDataModel.hpp"
+#include "Connection.hpp"
+#include "ConnectionGeometry.hpp"
+#include "NodePainter.hpp"
+#include "ConnectionPainter.hpp"
+
+using QtNodes::PlaceholderGraphicsItem;
+using QtNodes::FlowScene;
+using QtNodes::Node;
+using QtNodes::Connection;
+using QtNodes::ConnectionGeometry;
+using QtNodes::NodePainter;
+using QtNodes::ConnectionPainter;
+using QtNodes::PortType;
+
+PlaceholderGraphicsItem::
+PlaceholderGraphicsItem(FlowScene& scene)
+  : _scene(scene)
+  , _boundingRectValid(false)
+{
+  // only the exposed nodes are painted
+  setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+
+  // clicks go through to the view, as on the background
+  setAcceptedMouseButtons(Qt::NoButton);
+
+  // below the connections with a graphics object, at -1.0
+  setZValue(-2.0);
+}
+
+
+QRectF
+PlaceholderGraphicsItem::
+boundingRect() const
+{
+  if (_boundingRectValid)
+    return _boundingRect;
+
+  QRectF rect;
+  for (auto const & it : _scene.nodes())
+  {
+    Node const & node = *it.second;
+    if (!node.hasGraphicsObject())
+      rect |= node.nodeGeometry().boundingRect().translated(node.position());
+  }
+
+  _boundingRect = rect;
+  _boundingRectValid = true;
+  return _boundingRect;
+}
+
+
+void
+PlaceholderGraphicsItem::
+geometryChanged()
+{
+  if (!_boundingRectValid)
+    return;
+
+  prepareGeometryChange();
+  _boundingRectValid = false;
+}
+
+
+void
+PlaceholderGraphicsItem::
+paint(QPainter* painter,
+      QStyleOptionGraphicsItem const* option,
+      QWidget* )
+{
+  QRectF const exposed = option->exposedRect;
+
+  painter->setClipRect(exposed);
+
+  // the connections first, below the nodes
+  for (auto const & it : _scene.connections())
+  {
+    Connection & connection = *it.second;
+
+    Node* nodeIn  = connection.getNode(PortType::In);
+    Node* nodeOut = connection.getNode(PortType::Out);
+    if (connection.hasGraphicsObject() || !nodeIn || !nodeOut)
+      continue;
+
+    // in scene coordinates, as for a graphics object at the origin
+    ConnectionGeometry & geom = connection.connectionGeometry();
+    for (Node* node : {nodeIn, nodeOut})
+    {
+      PortType const portType = (node == nodeIn) ? PortType::In : PortType::Out;
+      QPointF const pos =
+        node->nodeGeometry().portScenePosition(connection.getPortIndex(portType),
+                                               portType,
+                                               node->sceneTransform());
+      if (pos != geom.getEndPoint(portType))
+        geom.setEndPoint(portType, pos);
+    }
+
+    if (exposed.intersects(geom.boundingRect()))
+      ConnectionPainter::paint(painter, connection, _scene.detailLevel());
+  }
+
+  for (auto const & it : _scene.nodes())
+  {
+    Node & node = *it.second;
+    if (node.hasGraphicsObject())
+      continue;
+
+    QPointF const pos = node.position();
+    if (!exposed.intersects(node.nodeGeometry().boundingRect().translated(pos)))
+      continue;
+
+    painter->save();
+    painter->translate(pos);
+    painter->setOpacity(node.nodeDataModel()->nodeStyle().Opacity);
+    NodePainter::paint(painter, node, _scene);
+    painter->restore();
+  }
+}
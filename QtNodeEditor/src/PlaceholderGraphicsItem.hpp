@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QtWidgets/QGraphicsItem>
+
+namespace QtNodes
+{
+
+class FlowScene;
+
+/// Paints the nodes of the scene that have no graphics object, and the
+/// connections between them, see FlowScene::setGraphicsOnDemand().
+/// They are painted as their own graphics objects would, but a single
+/// item doesn't let the user interact with them.
+class PlaceholderGraphicsItem : public QGraphicsItem
+{
+public:
+
+  PlaceholderGraphicsItem(FlowScene& scene);
+
+  QRectF
+  boundingRect() const override;
+
+  /// A node without graphics object was moved, resized, created or
+  /// removed, or one got or lost its graphics object.
+  void
+  geometryChanged();
+
+protected:
+
+  void
+  paint(QPainter* painter,
+        QStyleOptionGraphicsItem const* option,
+        QWidget* widget = 0) override;
+
+private:
+
+  FlowScene& _scene;
+
+  // union of the nodes without graphics object, recomputed lazily
+  mutable QRectF _boundingRect;
+  mutable bool _boundingRectValid;
+};
+}
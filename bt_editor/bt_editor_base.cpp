@@ -2,9 +2,41 @@
 #include <behaviortree_cpp_v3/decorators/subtree_node.h>
 #include <QDebug>
 
+namespace {
+
+// 64 bits FNV-1a
+const uint64_t HASH_SEED = 14695981039346656037ULL;
+
+uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+{
+    auto bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t HashValue(uint64_t hash, uint64_t value)
+{
+    return HashBytes( hash, &value, sizeof(value) );
+}
+
+uint64_t HashString(uint64_t hash, const QString& str)
+{
+    // the length makes ("ab","c") and ("a","bc") different
+    hash = HashValue( hash, static_cast<uint64_t>(str.size()) );
+    return HashBytes( hash, str.constData(), str.size() * sizeof(QChar) );
+}
+
+}
+
 void AbsBehaviorTree::clear()
 {
     _nodes.resize(0);
+    _hashes.clear();
+    _parents.clear();
 }
 
 
@@ -58,6 +90,9 @@ const AbstractTreeNode* AbsBehaviorTree::findFirstNode(const QString &instance_n
 AbstractTreeNode* AbsBehaviorTree::addNode(AbstractTreeNode* parent,
                                            AbstractTreeNode && new_node )
 {
+    // a leaf added to a tree already hashed: only its ancestors change
+    const bool hashed = parent && new_node.children_index.empty() &&
+                        _hashes.size() == _nodes.size();
     int index = _nodes.size();
     new_node.index = index;
     if( parent )
@@ -67,11 +102,64 @@ AbstractTreeNode* AbsBehaviorTree::addNode(AbstractTreeNode* parent,
     }
     else{
         _nodes.clear();
-        _nodes.push_back(new_node);
+        _nodes.push_back( std::move(new_node) );
+    }
+
+    if( hashed )
+    {
+        _hashes.push_back( 0 );
+        _parents.push_back( parent->index );
+        updateHashes( index );
+    }
+    else{
+        _hashes.clear();
     }
     return &_nodes.back();
 }
 
+void AbsBehaviorTree::setModel(size_t index, const NodeModelPtr &model)
+{
+    auto& node = _nodes.at(index);
+    if( node.model != model )
+    {
+        node.model = model;
+        updateHashes( index );
+    }
+}
+
+void AbsBehaviorTree::setInstanceName(size_t index, const QString &name)
+{
+    auto& node = _nodes.at(index);
+    if( node.instance_name != name )
+    {
+        node.instance_name = name;
+        updateHashes( index );
+    }
+}
+
+void AbsBehaviorTree::setPortsMapping(size_t index, const PortsMapping &ports_mapping)
+{
+    auto& node = _nodes.at(index);
+    if( node.ports_mapping != ports_mapping )
+    {
+        node.ports_mapping = ports_mapping;
+        updateHashes( index );
+    }
+}
+
+void AbsBehaviorTree::updateHashes(size_t index)
+{
+    // not computed yet, nothing to update
+    if( _hashes.size() != _nodes.size() )
+    {
+        return;
+    }
+    for (int i = int(index); i >= 0; i = _parents[i])
+    {
+        _hashes[i] = computeHash( i );
+    }
+}
+
 void AbsBehaviorTree::debugPrint() const
 {
     if( !rootNode() )
@@ -87,7 +175,7 @@ void AbsBehaviorTree::debugPrint() const
 
         printf("%s (%s)",
                node->instance_name.toStdString().c_str(),
-               node->model.registration_ID.toStdString().c_str() );
+               node->model->registration_ID.toStdString().c_str() );
         std::cout << std::endl; // force flush
 
         for(int index: node->children_index)
@@ -101,10 +189,71 @@ void AbsBehaviorTree::debugPrint() const
 
 }
 
+uint64_t AbsBehaviorTree::computeHash(size_t index) const
+{
+    const auto& node = _nodes[index];
+    uint64_t hash = HASH_SEED;
+    hash = HashString( hash, node.model->registration_ID );
+    hash = HashString( hash, node.instance_name );
+    hash = HashValue( hash, node.ports_mapping.size() );
+    for (const auto& port_it: node.ports_mapping)
+    {
+        hash = HashString( hash, port_it.first );
+        hash = HashString( hash, port_it.second );
+    }
+    hash = HashValue( hash, node.children_index.size() );
+    for (int child: node.children_index)
+    {
+        hash = HashValue( hash, _hashes[child] );
+    }
+    return hash;
+}
+
+uint64_t AbsBehaviorTree::nodeHash(size_t index) const
+{
+    if( _hashes.size() != _nodes.size() )
+    {
+        _hashes.assign( _nodes.size(), 0 );
+        _parents.assign( _nodes.size(), -1 );
+        std::vector<bool> visited( _nodes.size(), false );
+
+        std::function<void(size_t)> hashRecursively;
+        hashRecursively = [&](size_t i)
+        {
+            if( visited[i] )
+            {
+                return;
+            }
+            visited[i] = true;
+
+            for (int child: _nodes[i].children_index)
+            {
+                _parents[child] = int(i);
+                hashRecursively(child);
+            }
+            _hashes[i] = computeHash( i );
+        };
+
+        for (size_t i = 0; i < _nodes.size(); i++)
+        {
+            hashRecursively(i);
+        }
+    }
+    return _hashes.at(index);
+}
+
+uint64_t AbsBehaviorTree::contentHash() const
+{
+    return _nodes.empty() ? 0 : nodeHash(0);
+}
+
 bool AbsBehaviorTree::operator ==(const AbsBehaviorTree &other) const
 {
     if( _nodes.size() != other._nodes.size() ) return false;
 
+    // different structure, no need to look at the single nodes
+    if( contentHash() != other.contentHash() ) return false;
+
     for (size_t index = 0; index < _nodes.size(); index++)
     {
         if( _nodes[index] != other._nodes[index]) return false;
@@ -134,12 +283,14 @@ const char *toStr(GraphicMode type)
 
 bool AbstractTreeNode::operator ==(const AbstractTreeNode &other) const
 {
-    bool same_registration = model.registration_ID == other.model.registration_ID;
+    bool same_registration = model == other.model ||
+                             model->registration_ID == other.model->registration_ID;
     return  same_registration &&
             status == other.status &&
             size == other.size &&
           // temporary removed  pos == other.pos &&
-            instance_name == other.instance_name;
+            instance_name == other.instance_name &&
+            ports_mapping == other.ports_mapping;
 }
 
 bool NodeModel::operator ==(const NodeModel &other) const
@@ -185,6 +336,17 @@ NodeModel &NodeModel::operator =(const BT::TreeNodeManifest &src)
 }
 
 
+const NodeModelPtr &UndefinedNodeModel()
+{
+    static const NodeModelPtr undefined_model = []()
+    {
+        auto model = std::make_shared<NodeModel>();
+        model->type = NodeType::UNDEFINED;
+        return model;
+    }();
+    return undefined_model;
+}
+
 const NodeModels &BuiltinNodeModels()
 {
     static NodeModels builtin_node_models =
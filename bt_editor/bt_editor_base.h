@@ -8,6 +8,7 @@
 #include <unordered_map>
 #include <nodes/Node>
 #include <deque>
+#include <memory>
 #include <behaviortree_cpp_v3/bt_factory.h>
 
 using BT::NodeStatus;
@@ -48,6 +49,13 @@ struct  NodeModel
 
 typedef std::map<QString, NodeModel> NodeModels;
 
+// Models are immutable once registered: the nodes of a tree and their
+// graphic counterparts share a single copy of each of them.
+typedef std::shared_ptr<const NodeModel> NodeModelPtr;
+
+// Shared instance of a model with type UNDEFINED and an empty ID
+const NodeModelPtr& UndefinedNodeModel();
+
 
 enum class GraphicMode { EDITOR, MONITOR, REPLAY };
 
@@ -61,14 +69,13 @@ const NodeModels& BuiltinNodeModels();
 struct AbstractTreeNode
 {
     AbstractTreeNode() :
+        model(UndefinedNodeModel()),
         index(-1),
         status(NodeStatus::IDLE),
         graphic_node(nullptr)
-    {
-        model.type = NodeType::UNDEFINED;
-    }
+    {}
 
-    NodeModel model;
+    NodeModelPtr model;
     PortsMapping ports_mapping;
     int index;
     QString instance_name;
@@ -78,6 +85,8 @@ struct AbstractTreeNode
     std::vector<int> children_index;
     QtNodes::Node* graphic_node;
 
+    // Same registration ID, instance name, ports mapping, status and size.
+    // Position and children are not compared.
     bool operator ==(const AbstractTreeNode& other) const;
 
     bool operator !=(const AbstractTreeNode& other) const
@@ -102,6 +111,9 @@ public:
 
     const NodesVector& nodes() const { return _nodes; }
 
+    // Model, instance name, ports mapping and children of a node are part of
+    // the hashes: once the node is in the tree, change them only with the
+    // setters below. Nodes appended here are hashed when first needed.
     NodesVector& nodes() { return _nodes; }
 
     const AbstractTreeNode* node(size_t index) const { return &_nodes.at(index); }
@@ -118,8 +130,27 @@ public:
 
     AbstractTreeNode* addNode(AbstractTreeNode* parent, AbstractTreeNode &&new_node );
 
+    // Update the hashes of the node and its ancestors only
+    void setModel(size_t index, const NodeModelPtr& model);
+
+    void setInstanceName(size_t index, const QString& name);
+
+    void setPortsMapping(size_t index, const PortsMapping& ports_mapping);
+
     void debugPrint() const;
 
+    // Structural hash of the subtree that starts at the given node: it covers
+    // model ID, instance name and port mappings of its nodes, and their
+    // hierarchy. Equal subtrees have equal hashes, wherever they are.
+    // Position, size and status are not included.
+    // Computed for all the nodes on first use, then kept up to date by
+    // addNode() and the setters.
+    uint64_t nodeHash(size_t index) const;
+
+    // nodeHash() of the root, 0 if the tree is empty
+    uint64_t contentHash() const;
+
+    // Equal nodes, at the same indices, and the same hierarchy
     bool operator ==(const AbsBehaviorTree &other) const;
 
     bool operator !=(const AbsBehaviorTree &other) const{
@@ -129,7 +160,15 @@ public:
     void clear();
 
 private:
+    // from the fields of the node and the hashes of its children
+    uint64_t computeHash(size_t index) const;
+
+    void updateHashes(size_t index);
+
     NodesVector _nodes;
+    mutable std::vector<uint64_t> _hashes;
+    // index of the parent of each node, -1 for the root
+    mutable std::vector<int> _parents;
 };
 
 static int GetUID()
@@ -8,6 +8,8 @@
 #include <QApplication>
 #include "models/BehaviorTreeNodeModel.hpp"
 #include <QGraphicsView>
+#include <QGraphicsProxyWidget>
+#include <QLineEdit>
 
 #include <nodes/Node>
 
@@ -58,23 +60,17 @@ void EditorFlowScene::dragMoveEvent(QGraphicsSceneDragDropEvent* event)
 
 void EditorFlowScene::keyPressEvent(QKeyEvent *event)
 {
-
-    for( const auto& it: nodes())
+    // the widgets of the nodes and the editors of the painted fields.
+    // Asking each node for its widget would create them all
+    auto proxy = dynamic_cast<QGraphicsProxyWidget*>( focusItem() );
+    if( proxy && proxy->widget() && qobject_cast<QLineEdit*>( proxy->widget()->focusWidget() ) )
     {
-        const auto& node = it.second;
-        auto line_edits = node->nodeDataModel()->embeddedWidget()->findChildren<QLineEdit*>();
-        for(auto line_edit: line_edits )
-        {
-            if( line_edit->hasFocus() )
-            {
-                // Do not swallow the keyPressEvent, you are editing a QLineEdit
-                QGraphicsScene::keyPressEvent(event);
-                return;
-            }
-        }
+        // Do not swallow the keyPressEvent, you are editing a QLineEdit
+        QGraphicsScene::keyPressEvent(event);
+        return;
     }
 
-    const QString& registration_ID = _clipboard_node.model.registration_ID;
+    const QString& registration_ID = _clipboard_node.model->registration_ID;
 
     auto selected_items = selectedItems();
     if( selected_items.size() == 1 &&
@@ -88,7 +84,7 @@ void EditorFlowScene::keyPressEvent(QKeyEvent *event)
         auto node_model = dynamic_cast<BehaviorTreeDataModel*>( selected_node.nodeDataModel() );
         if( !node_model ) return;
 
-        _clipboard_node.model = node_model->model();
+        _clipboard_node.model = node_model->modelPtr();
         _clipboard_node.instance_name  = node_model->instanceName();
     }
     else if( event->key() == Qt::Key_V &&
@@ -0,0 +1,173 @@
+#include "flatbuffer_tree_view.h"
+#include <map>
+#include <algorithm>
+#include <stdexcept>
+#include "utils.h"
+
+namespace {
+
+const QString& RootName()
+{
+    static const QString root_name("Root");
+    return root_name;
+}
+
+}
+
+bool FlatbufferTreeView::load(const QByteArray &buffer)
+{
+    if( _tree && buffer == _buffer )
+    {
+        return false;
+    }
+    clear();
+
+    _buffer = buffer;
+    _tree = Serialization::GetBehaviorTree( _buffer.constData() );
+
+    const auto fb_nodes = _tree->nodes();
+    _nodes.reserve( fb_nodes->size() + 1 );
+    _nodes.push_back( nullptr );
+
+    int max_uid = -1;
+    for( const Serialization::TreeNode* fb_node: *fb_nodes )
+    {
+        _nodes.push_back( fb_node );
+        max_uid = std::max( max_uid, int(fb_node->uid()) );
+    }
+
+    _uid_lookup.assign( max_uid + 1, -1 );
+    for (size_t index = 1; index < _nodes.size(); index++)
+    {
+        _uid_lookup[ _nodes[index]->uid() ] = int32_t(index);
+    }
+
+    _instance_names.resize( _nodes.size() );
+    _registration_IDs.resize( _nodes.size() );
+    return true;
+}
+
+void FlatbufferTreeView::clear()
+{
+    _buffer.clear();
+    _tree = nullptr;
+    _nodes.clear();
+    _uid_lookup.clear();
+    _instance_names.clear();
+    _registration_IDs.clear();
+}
+
+const QString &FlatbufferTreeView::instanceName(size_t index) const
+{
+    if( index == 0 )
+    {
+        return RootName();
+    }
+    QString& name = _instance_names.at(index);
+    if( name.isNull() )
+    {
+        name = QString::fromUtf8( _nodes[index]->instance_name()->c_str() );
+    }
+    return name;
+}
+
+const QString &FlatbufferTreeView::registrationID(size_t index) const
+{
+    if( index == 0 )
+    {
+        return RootName();
+    }
+    QString& ID = _registration_IDs.at(index);
+    if( ID.isNull() )
+    {
+        ID = QString::fromUtf8( _nodes[index]->registration_name()->c_str() );
+    }
+    return ID;
+}
+
+NodeStatus FlatbufferTreeView::status(size_t index) const
+{
+    return (index == 0) ? NodeStatus::IDLE : convert( _nodes.at(index)->status() );
+}
+
+AbsBehaviorTree FlatbufferTreeView::toAbsTree() const
+{
+    AbsBehaviorTree tree;
+    if( !_tree )
+    {
+        return tree;
+    }
+
+    auto root_model = std::make_shared<NodeModel>();
+    root_model->type = NodeType::UNDEFINED;
+    root_model->registration_ID = RootName();
+
+    AbstractTreeNode abs_root;
+    abs_root.instance_name = RootName();
+    abs_root.model = root_model;
+    abs_root.children_index.push_back( 1 );
+
+    tree.addNode( nullptr, std::move(abs_root) );
+
+    //-----------------------------------------
+    // looked up by the raw strings of the buffer, without creating QStrings
+    std::map<std::string, NodeModelPtr, std::less<>> models;
+
+    for( const Serialization::NodeModel* model_node: *(_tree->node_models()) )
+    {
+        auto model_ptr = std::make_shared<NodeModel>();
+        NodeModel& model = *model_ptr;
+        model.registration_ID = QString::fromUtf8( model_node->registration_name()->c_str() );
+        model.type = convert( model_node->type() );
+
+        for( const Serialization::PortModel* port: *(model_node->ports()) )
+        {
+            PortModel port_model;
+            QString port_name = QString::fromUtf8( port->port_name()->c_str() );
+            port_model.direction = convert( port->direction() );
+            port_model.type_name = QString::fromUtf8( port->type_info()->c_str() );
+            port_model.description = QString::fromUtf8( port->description()->c_str() );
+
+            model.ports.insert( { port_name, std::move(port_model) } );
+        }
+
+        models.insert( { model_node->registration_name()->str(), std::move(model_ptr)} );
+    }
+
+    //-----------------------------------------
+    auto& nodes = tree.nodes();
+    for (size_t index = 1; index < _nodes.size(); index++)
+    {
+        const Serialization::TreeNode* fb_node = _nodes[index];
+
+        const auto model_it = models.find( fb_node->registration_name()->c_str() );
+        if( model_it == models.end() )
+        {
+            throw std::out_of_range( std::string("Missing model of the node ") +
+                                     fb_node->registration_name()->c_str() );
+        }
+
+        AbstractTreeNode abs_node;
+        abs_node.index = int(index);
+        abs_node.instance_name = instanceName( index );
+        abs_node.status = convert( fb_node->status() );
+        abs_node.model = model_it->second;
+
+        for( const Serialization::PortConfig* pair: *(fb_node->port_remaps()) )
+        {
+            abs_node.ports_mapping.insert( { QString::fromUtf8( pair->port_name()->c_str() ),
+                                             QString::fromUtf8( pair->remap()->c_str() ) } );
+        }
+
+        for( const auto child_uid: *(fb_node->children_uid()) )
+        {
+            const int child_index = indexOf( child_uid );
+            if( child_index > 0 )
+            {
+                abs_node.children_index.push_back( child_index );
+            }
+        }
+        nodes.push_back( std::move(abs_node) );
+    }
+    return tree;
+}
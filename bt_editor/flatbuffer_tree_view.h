@@ -0,0 +1,72 @@
+#ifndef FLATBUFFER_TREE_VIEW_H
+#define FLATBUFFER_TREE_VIEW_H
+
+#include <vector>
+#include <cstdint>
+#include <QByteArray>
+#include <QString>
+#include "bt_editor_base.h"
+#include <behaviortree_cpp_v3/flatbuffers/BT_logger_generated.h>
+
+/// Read-only tree stored in a flatbuffer (Serialization::BehaviorTree), as
+/// found in the header of a log or in the reply of a monitored executor.
+///
+/// The buffer is retained. The lookups by UID and the status of the nodes
+/// need no conversion, instanceName() and registrationID() convert a single
+/// string on first request. toAbsTree() instead converts the strings of
+/// every node, because the scene keeps its own copy of them. The indexes
+/// are the same of the tree returned by toAbsTree(), where index 0 is the
+/// "Root" node added by the editor.
+class FlatbufferTreeView
+{
+public:
+
+    // The buffer must have been verified already. It is retained, not copied
+    // (QByteArray is implicitly shared): don't pass QByteArray::fromRawData().
+    // Return false if it contains the same tree already loaded; in that
+    // case nothing changes.
+    bool load(const QByteArray& buffer);
+
+    void clear();
+
+    bool empty() const { return _tree == nullptr; }
+
+    const QByteArray& buffer() const { return _buffer; }
+
+    // Including the "Root" node
+    size_t nodesCount() const { return _nodes.size(); }
+
+    // Index of the node with the given UID, -1 if unknown
+    int indexOf(int uid) const
+    {
+        return (uid >= 0 && uid < int(_uid_lookup.size())) ? _uid_lookup[uid] : -1;
+    }
+
+    // Dense UID -> index table, -1 for unknown UIDs
+    const std::vector<int32_t>& uidLookup() const { return _uid_lookup; }
+
+    // nullptr for the "Root" node
+    const Serialization::TreeNode* fbNode(size_t index) const { return _nodes.at(index); }
+
+    const QString& instanceName(size_t index) const;
+
+    const QString& registrationID(size_t index) const;
+
+    NodeStatus status(size_t index) const;
+
+    // The whole tree, with the strings of all the nodes converted.
+    // The nodes with the same registration ID share their model.
+    AbsBehaviorTree toAbsTree() const;
+
+private:
+    QByteArray _buffer;
+    const Serialization::BehaviorTree* _tree = nullptr;
+    std::vector<const Serialization::TreeNode*> _nodes;
+    std::vector<int32_t> _uid_lookup;
+
+    // materialized on demand
+    mutable std::vector<QString> _instance_names;
+    mutable std::vector<QString> _registration_IDs;
+};
+
+#endif // FLATBUFFER_TREE_VIEW_H
@@ -11,6 +11,9 @@
 #include <QMessageBox>
 #include <QApplication>
 #include <QInputDialog>
+#include <QGraphicsProxyWidget>
+#include <QLineF>
+#include <algorithm>
 
 using namespace QtNodes;
 
@@ -18,14 +21,59 @@ GraphicContainer::GraphicContainer(std::shared_ptr<DataModelRegistry> model_regi
                                    QWidget *parent) :
     QObject(parent),
     _model_registry( std::move(model_registry) ),
-    _signal_was_blocked(true)
+    _signal_was_blocked(true),
+    _cached_tree_revision(0),
+    _cached_tree_topology(0),
+    _cached_tree_layout(QtNodes::PortLayout::Vertical),
+    _cached_validity(false),
+    _cached_validity_revision(0),
+    _editing_locked(false),
+    _locked_topology_revision(0),
+    _widgets_virtualized(false)
 {
     _scene = new EditorFlowScene( _model_registry, parent );
     _view  = new QtNodes::FlowView( _scene, parent );
 
+    // one repaint per frame, no matter how many status changes arrive
+    _restyle_timer.setSingleShot( true );
+    _restyle_timer.setInterval( 16 );
+    connect( &_restyle_timer, &QTimer::timeout,
+             this, &GraphicContainer::flushStyleUpdates );
+
+    // at most one update of the widgets every few frames, while panning
+    _widgets_timer.setSingleShot( true );
+    _widgets_timer.setInterval( 50 );
+    connect( &_widgets_timer, &QTimer::timeout,
+             this, &GraphicContainer::updateNodeWidgets );
+
+    auto scheduleWidgetsUpdate = [this]()
+    {
+        if( !_widgets_timer.isActive() )
+        {
+            _widgets_timer.start();
+        }
+    };
+    connect( _view, &QtNodes::FlowView::visibleAreaChanged,
+             this, scheduleWidgetsUpdate );
+    connect( _scene, &QtNodes::FlowScene::batchCommitted,
+             this, scheduleWidgetsUpdate );
+
     connect( _scene, &QtNodes::FlowScene::nodeDoubleClicked,
              this, &GraphicContainer::onNodeDoubleClicked);
 
+    // the graphics objects of a large tree come and go, see updateNodeGraphics()
+    connect( _scene, &QtNodes::FlowScene::nodeGraphicsCreated,
+             this, &GraphicContainer::lockNodeGraphics );
+
+    connect( _scene, &QtNodes::FlowScene::connectionGraphicsCreated,
+             this, [](QtNodes::Connection &c )
+    {
+        // locked with the node it comes from, as in lockSubtreeEditing()
+        auto bt_model = dynamic_cast<BehaviorTreeDataModel*>(
+                    c.getNode(QtNodes::PortType::Out)->nodeDataModel() );
+        c.connectionGraphicsObject().lock( bt_model && bt_model->locked() );
+    });
+
     connect( _scene, &QtNodes::FlowScene::nodeCreated,
              this,   &GraphicContainer::onNodeCreated  );
 
@@ -35,13 +83,25 @@ GraphicContainer::GraphicContainer(std::shared_ptr<DataModelRegistry> model_regi
     connect( _scene, &QtNodes::FlowScene::connectionContextMenu,
              this, &GraphicContainer::onConnectionContextMenu );
 
+    // the changes made within a batch are notified once, when it is committed
+    auto sceneChanged = [this]()
+    {
+        if( !_scene->inBatch() )
+        {
+            undoableChange();
+        }
+    };
+
     connect( _scene, &QtNodes::FlowScene::nodeDeleted,
-             this,   &GraphicContainer::undoableChange  );
+             this,   sceneChanged  );
 
     connect( _scene, &QtNodes::FlowScene::nodeMoved,
-             this,   &GraphicContainer::undoableChange  );
+             this,   sceneChanged  );
 
     connect( _scene, &QtNodes::FlowScene::connectionDeleted,
+             this,   sceneChanged  );
+
+    connect( _scene, &QtNodes::FlowScene::batchCommitted,
              this,   &GraphicContainer::undoableChange  );
 
     connect( _view, &QtNodes::FlowView::startNodeDelete,
@@ -61,7 +121,8 @@ GraphicContainer::GraphicContainer(std::shared_ptr<DataModelRegistry> model_regi
     connect( _scene, &QtNodes::FlowScene::connectionCreated,
              this, [this](QtNodes::Connection &c )
     {
-        if( c.getNode(QtNodes::PortType::In) && c.getNode(QtNodes::PortType::Out))
+        if( c.getNode(QtNodes::PortType::In) && c.getNode(QtNodes::PortType::Out) &&
+            !_scene->inBatch() )
         {
             undoableChange();
         }
@@ -71,6 +132,17 @@ GraphicContainer::GraphicContainer(std::shared_ptr<DataModelRegistry> model_regi
 
 void GraphicContainer::lockEditing(bool locked)
 {
+    // called after every change: only new nodes and connections matter
+    if( locked == _editing_locked &&
+        _locked_topology_revision == _scene->topologyRevision() )
+    {
+        return;
+    }
+    _editing_locked = locked;
+    _locked_topology_revision = _scene->topologyRevision();
+
+    const bool virtualized = _scene->nodes().size() > VIRTUALIZATION_THRESHOLD;
+
     std::vector<QtNodes::Node*> subtrees_expanded;
     for (auto& nodes_it: _scene->nodes() )
     {
@@ -78,18 +150,29 @@ void GraphicContainer::lockEditing(bool locked)
         QtNodes::Node* node = nodes_it.second.get();
         auto bt_model = dynamic_cast<BehaviorTreeDataModel*>( node->nodeDataModel() );
 
+        // a tree that can't be edited doesn't need widgets, while
+        // the ones of a large tree are given by updateNodeWidgets()
+        if( locked )
+        {
+            bt_model->setPainted( true );
+            bt_model->releaseWidgets();
+        }
+        else if( !virtualized )
+        {
+            bt_model->setPainted( false );
+        }
+
+        bt_model->lock( locked );
+        if( node->hasGraphicsObject() )
+        {
+            lockNodeGraphics( *node );
+        }
+
         if(bt_model->registrationName() == "Root")
         {
-            bt_model->lock( locked );
-            node->nodeGraphicsObject().setFlag(QGraphicsItem::ItemIsMovable,  false);
-            node->nodeGraphicsObject().setFlag(QGraphicsItem::ItemIsFocusable, true);
-            node->nodeGraphicsObject().setFlag(QGraphicsItem::ItemIsSelectable, false);
             continue;
         }
 
-        bt_model->lock(locked);
-        node->nodeGraphicsObject().lock(locked);
-
         if( auto subtree = dynamic_cast<SubtreeNodeModel*>( node->nodeDataModel() ) )
         {
             if( subtree->expanded()) subtrees_expanded.push_back(node);
@@ -97,10 +180,13 @@ void GraphicContainer::lockEditing(bool locked)
 
         if( !locked )
         {
-            node->nodeGraphicsObject().setGeometryChanged();
+            if( node->hasGraphicsObject() )
+            {
+                node->nodeGraphicsObject().setGeometryChanged();
+            }
             QtNodes::NodeStyle style;
             node->nodeDataModel()->setNodeStyle( style );
-            node->nodeGraphicsObject().update();
+            _scene->updateNode( *node );
         }
     }
 
@@ -112,15 +198,182 @@ void GraphicContainer::lockEditing(bool locked)
     for (auto& conn_it: _scene->connections() )
     {
         QtNodes::Connection* conn = conn_it.second.get();
-        conn->connectionGraphicsObject().lock( locked );
+        if( conn->hasGraphicsObject() )
+        {
+            conn->connectionGraphicsObject().lock( locked );
+        }
+    }
+
+    if( virtualized && !locked && !_widgets_timer.isActive() )
+    {
+        _widgets_timer.start();
+    }
+}
+
+void GraphicContainer::updateNodeWidgets()
+{
+    _widgets_timer.stop();
+
+    const bool virtualized = _scene->nodes().size() > VIRTUALIZATION_THRESHOLD;
+
+    // half a screen around the visible area, ready to be panned into
+    QRectF area = _view->mapToScene( _view->viewport()->rect() ).boundingRect();
+    area.adjust( -area.width()*0.5, -area.height()*0.5,
+                  area.width()*0.5,  area.height()*0.5 );
+
+    // for the trees that can't be edited too: monitor and replay
+    _scene->setGraphicsOnDemand( virtualized );
+    if( virtualized )
+    {
+        updateNodeGraphics( area );
+    }
+
+    // a tree that can't be edited has no widgets at all, while the
+    // small ones have them all, since lockEditing()
+    if( _editing_locked || (!virtualized && !_widgets_virtualized) )
+    {
+        return;
+    }
+    _widgets_virtualized = virtualized;
+
+    const bool full_detail = _view->detailLevel() == QtNodes::DetailLevel::Full;
+
+    // resizing the nodes moves them, that is not an undoable change
+    const QSignalBlocker blocker( this );
+
+    for (auto& nodes_it: _scene->nodes() )
+    {
+        QtNodes::Node* node = nodes_it.second.get();
+        auto bt_model = dynamic_cast<BehaviorTreeDataModel*>( node->nodeDataModel() );
+        if( !bt_model )
+        {
+            continue;
+        }
+        // a widget needs the graphics object of its node
+        const bool near = !virtualized ||
+                ( full_detail && !bt_model->paintedEditable() &&
+                  node->hasGraphicsObject() &&
+                  area.intersects( node->nodeGraphicsObject().sceneBoundingRect() ) );
+
+        bt_model->setPainted( !near );
+        if( !near )
+        {
+            bt_model->releaseWidgets();
+        }
     }
 }
 
+void GraphicContainer::updateNodeGraphics(const QRectF& area)
+{
+    const size_t max_graphics = MAX_NODE_GRAPHICS;
+    const QPointF center = area.center();
+
+    std::vector<std::pair<qreal, QtNodes::Node*>> near_nodes;
+    std::vector<QtNodes::Node*> far_nodes;
+
+    for (auto& nodes_it: _scene->nodes() )
+    {
+        QtNodes::Node* node = nodes_it.second.get();
+        const QRectF rect = node->nodeGeometry().boundingRect()
+                                .translated( _scene->getNodePosition( *node ) );
+        if( area.intersects( rect ) )
+        {
+            near_nodes.push_back( { QLineF( center, rect.center() ).length(), node } );
+        }
+        else if( node->hasGraphicsObject() )
+        {
+            far_nodes.push_back( node );
+        }
+    }
+
+    // zoomed out, too many of them are visible
+    if( near_nodes.size() > max_graphics )
+    {
+        auto by_distance = [](const std::pair<qreal, QtNodes::Node*>& a,
+                              const std::pair<qreal, QtNodes::Node*>& b)
+        {
+            return a.first < b.first;
+        };
+        std::nth_element( near_nodes.begin(), near_nodes.begin() + max_graphics,
+                          near_nodes.end(), by_distance );
+
+        for (size_t i = max_graphics; i < near_nodes.size(); i++)
+        {
+            if( near_nodes[i].second->hasGraphicsObject() )
+            {
+                far_nodes.push_back( near_nodes[i].second );
+            }
+        }
+        near_nodes.resize( max_graphics );
+    }
+
+    // the ones being selected or edited are kept by the scene
+    for (auto node: far_nodes )
+    {
+        _scene->releaseNodeGraphics( *node );
+    }
+    for (auto& it: near_nodes )
+    {
+        _scene->createNodeGraphics( *it.second );
+    }
+}
+
+void GraphicContainer::lockNodeGraphics(Node &node)
+{
+    auto bt_model = dynamic_cast<BehaviorTreeDataModel*>( node.nodeDataModel() );
+    if( !bt_model )
+    {
+        return;
+    }
+
+    auto& graphic_object = node.nodeGraphicsObject();
+    if( bt_model->registrationName() == "Root" )
+    {
+        graphic_object.setFlag(QGraphicsItem::ItemIsMovable,  false);
+        graphic_object.setFlag(QGraphicsItem::ItemIsFocusable, true);
+        graphic_object.setFlag(QGraphicsItem::ItemIsSelectable, false);
+    }
+    else
+    {
+        graphic_object.lock( bt_model->locked() );
+    }
+}
+
+void GraphicContainer::paintLargeTree()
+{
+    const bool large = _scene->nodes().size() > VIRTUALIZATION_THRESHOLD;
+
+    // the loaded tree might not be the one expected, and the locked
+    // ones need graphics objects near the visible area too
+    _scene->setGraphicsOnDemand( large );
+    if( large && !_widgets_timer.isActive() )
+    {
+        _widgets_timer.start();
+    }
+
+    if( _editing_locked || !large )
+    {
+        return;
+    }
+    for (auto& nodes_it: _scene->nodes() )
+    {
+        if( auto bt_model = dynamic_cast<BehaviorTreeDataModel*>( nodes_it.second->nodeDataModel() ) )
+        {
+            bt_model->setPainted( true );
+            bt_model->releaseWidgets();
+        }
+    }
+    _widgets_virtualized = true;
+}
+
 void GraphicContainer::lockSubtreeEditing(Node &root_node, bool locked, bool change_style)
 {
     for (auto node: getSubtreeNodesRecursively( root_node ) )
     {
-        node->nodeGraphicsObject().lock( locked );
+        if( node->hasGraphicsObject() )
+        {
+            node->nodeGraphicsObject().lock( locked );
+        }
 
         if( auto bt_model = dynamic_cast<BehaviorTreeDataModel*>( node->nodeDataModel() ) )
         {
@@ -133,7 +386,10 @@ void GraphicContainer::lockSubtreeEditing(Node &root_node, bool locked, bool cha
             for (auto& conn_it: conn_by_port )
             {
                 QtNodes::Connection* conn = conn_it.second;
-                conn->connectionGraphicsObject().lock( locked );
+                if( conn->hasGraphicsObject() )
+                {
+                    conn->connectionGraphicsObject().lock( locked );
+                }
             }
         }
         //--------------------------------
@@ -146,9 +402,12 @@ void GraphicContainer::lockSubtreeEditing(Node &root_node, bool locked, bool cha
             style.GradientColor2.setBlue(90);
             style.GradientColor3.setBlue(90);
         }
-        node->nodeGraphicsObject().setGeometryChanged();
+        if( node->hasGraphicsObject() )
+        {
+            node->nodeGraphicsObject().setGeometryChanged();
+        }
         node->nodeDataModel()->setNodeStyle( style );
-        node->nodeGraphicsObject().update();
+        _scene->updateNode( *node );
     }
 }
 
@@ -156,8 +415,12 @@ void GraphicContainer::nodeReorder()
 {
     {
         const QSignalBlocker blocker(this);
-        auto abstract_tree = BuildTreeFromScene( _scene );
-        NodeReorder( *_scene, abstract_tree );
+        auto abstract_tree = loadedTree();
+        {
+            QtNodes::FlowSceneBatch batch( *_scene );
+            NodeReorder( *_scene, abstract_tree );
+            batch.commit();
+        }
         zoomHomeView();
     }
     emit undoableChange();
@@ -165,7 +428,7 @@ void GraphicContainer::nodeReorder()
 
 void GraphicContainer::zoomHomeView()
 {
-    QRectF rect = _scene->itemsBoundingRect();
+    QRectF rect = _scene->nodesBoundingRect();
     rect.setBottom( rect.top() + rect.height()* 1.2 );
 
     const int min_height = 300;
@@ -181,6 +444,14 @@ void GraphicContainer::zoomHomeView()
 
 bool GraphicContainer::containsValidTree() const
 {
+    // only nodes and connections matter
+    if( _cached_validity_revision == _scene->topologyRevision() )
+    {
+        return _cached_validity;
+    }
+    _cached_validity_revision = _scene->topologyRevision();
+    _cached_validity = false;
+
     if( _scene->nodes().empty())
     {
         return false;
@@ -222,6 +493,79 @@ bool GraphicContainer::containsValidTree() const
             }
         }
     }
+    _cached_validity = true;
+    return true;
+}
+
+const AbsBehaviorTree& GraphicContainer::loadedTree() const
+{
+    if( _cached_tree_revision == _scene->revision() )
+    {
+        return _cached_tree;
+    }
+
+    std::set<QUuid> touched_nodes;
+    const bool patched = _cached_tree_topology == _scene->topologyRevision() &&
+                         _cached_tree_layout == _scene->layout() &&
+                         _scene->touchedNodesSince( _cached_tree_revision, touched_nodes ) &&
+                         patchLoadedTree( touched_nodes );
+    if( !patched )
+    {
+        _cached_tree = BuildTreeFromScene( _scene );
+        _cached_tree_topology = _scene->topologyRevision();
+        _cached_tree_layout = _scene->layout();
+
+        _cached_tree_index.clear();
+        for (const auto& abs_node: _cached_tree.nodes())
+        {
+            _cached_tree_index[ abs_node.graphic_node->id() ] = abs_node.index;
+        }
+    }
+    _cached_tree_revision = _scene->revision();
+    return _cached_tree;
+}
+
+bool GraphicContainer::patchLoadedTree(const std::set<QUuid> &touched_nodes) const
+{
+    std::set<int> parents;
+    for (const QUuid& id: touched_nodes)
+    {
+        auto index_it = _cached_tree_index.find( id );
+        if( index_it == _cached_tree_index.end() )
+        {
+            continue; // removed, or not connected to the root
+        }
+        const int index = index_it->second;
+        QtNodes::Node* node = _cached_tree.node( index )->graphic_node;
+        auto bt_model = dynamic_cast<BehaviorTreeDataModel*>( node->nodeDataModel() );
+
+        _cached_tree.setModel( index, bt_model->modelPtr() );
+        _cached_tree.setInstanceName( index, bt_model->instanceName() );
+        _cached_tree.setPortsMapping( index, bt_model->getCurrentPortMapping() );
+
+        AbstractTreeNode* abs_node = _cached_tree.node( index );
+        abs_node->pos  = _scene->getNodePosition( *node );
+        abs_node->size = _scene->getNodeSize( *node );
+
+        if( auto parent = _scene->parentNode( *node ) )
+        {
+            parents.insert( _cached_tree_index.at( parent->id() ) );
+        }
+    }
+
+    // the children are sorted by position, moving one can change the order
+    for (int parent_index: parents)
+    {
+        const AbstractTreeNode* parent = _cached_tree.node( parent_index );
+        const auto children = getChildren( *_scene, *parent->graphic_node, true );
+        for (size_t i = 0; i < children.size(); i++)
+        {
+            if( _cached_tree.node( parent->children_index[i] )->graphic_node != children[i] )
+            {
+                return false;
+            }
+        }
+    }
     return true;
 }
 
@@ -232,6 +576,64 @@ void GraphicContainer::clearScene()
 }
 
 
+void GraphicContainer::applyNodeStyle(Node &node,
+                                      const NodeStyle &node_style,
+                                      const ConnectionStyle &conn_style)
+{
+    bool changed = false;
+
+    if( node.nodeDataModel()->nodeStyle() != node_style )
+    {
+        node.nodeDataModel()->setNodeStyle( node_style );
+        changed = true;
+    }
+
+    const auto& conn_in = node.nodeState().connections(PortType::In, 0 );
+    if( conn_in.size() == 1 )
+    {
+        auto conn = conn_in.begin()->second;
+        if( conn->style() != conn_style )
+        {
+            conn->setStyle( conn_style );
+            changed = true;
+        }
+    }
+
+    if( changed )
+    {
+        _restyled_nodes.insert( node.id() );
+        if( !_restyle_timer.isActive() )
+        {
+            _restyle_timer.start();
+        }
+    }
+}
+
+void GraphicContainer::flushStyleUpdates()
+{
+    // The items outside the viewport are only marked dirty: with
+    // SmartViewportUpdate the view repaints the visible ones only
+    const auto& nodes = _scene->nodes();
+    for (const QUuid& id: _restyled_nodes)
+    {
+        auto it = nodes.find( id );
+        if( it == nodes.end() )
+        {
+            continue;
+        }
+        auto& node = *it->second;
+        _scene->updateNode( node );
+
+        const auto& conn_in = node.nodeState().connections(PortType::In, 0 );
+        if( conn_in.size() == 1 )
+        {
+            _scene->updateConnection( *conn_in.begin()->second );
+        }
+    }
+    _restyled_nodes.clear();
+}
+
+
 std::set<QtNodes::Node*> GraphicContainer::getSubtreeNodesRecursively(Node &root_node)
 {
     std::set<QtNodes::Node*> nodes;
@@ -303,8 +705,46 @@ void GraphicContainer::createSubtree(Node &root_node, QString subtree_name )
     emit requestSubTreeCreate( sub_tree, subtree_name );
 }
 
-void GraphicContainer::onNodeDoubleClicked(Node &root_node)
+bool GraphicContainer::editPaintedField(Node &node, const QPointF &scene_pos)
 {
+    auto bt_model = dynamic_cast<BehaviorTreeDataModel*>( node.nodeDataModel() );
+    if( _editing_locked || !bt_model ||
+        _view->detailLevel() != QtNodes::DetailLevel::Full )
+    {
+        return false;
+    }
+    auto& graphic_object = node.nodeGraphicsObject();
+    const QPointF body_pos = node.nodeGeometry().widgetPosition();
+
+    QRectF field_rect;
+    QLineEdit* editor = bt_model->createFieldEditor(
+                graphic_object.mapFromScene( scene_pos ) - body_pos, &field_rect );
+    if( !editor )
+    {
+        return false;
+    }
+    // child of the node, it moves with it and it is deleted with it
+    auto proxy = new QGraphicsProxyWidget( &graphic_object );
+    proxy->setWidget( editor );
+    proxy->setPos( body_pos + field_rect.topLeft() );
+
+    // deleting the editor deletes the proxy too
+    connect( editor, &QLineEdit::editingFinished, editor, &QObject::deleteLater );
+    connect( editor, &QObject::destroyed, &graphic_object, [&graphic_object]()
+    {
+        graphic_object.update();
+    });
+    editor->setFocus();
+    editor->selectAll();
+    return true;
+}
+
+void GraphicContainer::onNodeDoubleClicked(Node &root_node, const QPointF &scene_pos)
+{
+    if( editPaintedField( root_node, scene_pos ) )
+    {
+        return;
+    }
     auto nodes = getSubtreeNodesRecursively(root_node);
     for(auto node: nodes)
     {
@@ -326,6 +766,16 @@ void GraphicContainer::onNodeCreated(Node &node)
 {
     if( auto bt_node = dynamic_cast<BehaviorTreeDataModel*>( node.nodeDataModel() ) )
     {
+        // the scene doesn't know about these changes, but the tree and the
+        // undo history do. Connected first, to be seen by undoableChange.
+        auto touchNode = [this, &node]() { _scene->touch( node ); };
+
+        connect( bt_node, &BehaviorTreeDataModel::instanceNameChanged,
+                 _scene, touchNode );
+
+        connect( bt_node, &BehaviorTreeDataModel::portMappingChanged,
+                 _scene, touchNode );
+
         connect( bt_node, &BehaviorTreeDataModel::parameterUpdated,
                  this, &GraphicContainer::undoableChange );
 
@@ -338,20 +788,25 @@ void GraphicContainer::onNodeCreated(Node &node)
         if( auto subtree_node = dynamic_cast<SubtreeNodeModel*>( bt_node ) )
         {
             auto main_win = dynamic_cast<MainWindow*>( parent() );
-            if( main_win && main_win->getTabByName( bt_node->registrationName() ) == nullptr  )
+            if( !subtree_node->painted() && main_win &&
+                main_win->getTabByName( bt_node->registrationName() ) == nullptr  )
             {
                 subtree_node->expandButton()->setEnabled(true);
             }
             connect( subtree_node, &SubtreeNodeModel::expandButtonPushed,
                      &(node), [&node, this]()
             {
+                _scene->touch( node );
                 emit requestSubTreeExpand( *this, node );
             });
         }
 
         bt_node->initWidget();
     }
-    undoableChange();
+    if( !_scene->inBatch() )
+    {
+        undoableChange();
+    }
 }
 
 void GraphicContainer::onNodeContextMenu(Node &node, const QPointF &)
@@ -534,7 +989,7 @@ void GraphicContainer::createSmartRemoveAction(QtNodes::Node &node, QMenu* node_
 
 void GraphicContainer::onSmartRemove(QtNodes::Node* node)
 {
-    auto parent_node = GetParentNode( node );
+    auto parent_node = _scene->parentNode( *node );
     NodeState::ConnectionPtrSet conn_out = node->nodeState().connections(PortType::Out, 0);
 
     if( !parent_node || conn_out.size() == 0 )
@@ -563,7 +1018,7 @@ void GraphicContainer::insertNodeInConnection(Connection &connection, QString no
         auto parent_node = connection.getNode(PortType::Out);
         auto child_node  = connection.getNode(PortType::In);
 
-        QPointF pos = child_node->nodeGraphicsObject().pos();
+        QPointF pos = _scene->getNodePosition( *child_node );
         pos.setX( pos.x() - 50 );
 
         QtNodes::Node& inserted_node = _scene->createNodeAtPos( node_name, node_name, pos );
@@ -620,7 +1075,7 @@ void GraphicContainer::recursiveLoadStep(QPointF& cursor,
                                          AbstractTreeNode* abs_node,
                                          Node* parent_node, int nest_level)
 {
-    Node& new_node = _scene->createNodeAtPos( abs_node->model.registration_ID,
+    Node& new_node = _scene->createNodeAtPos( abs_node->model->registration_ID,
                                               abs_node->instance_name,
                                               cursor);
     BehaviorTreeDataModel* bt_node = dynamic_cast<BehaviorTreeDataModel*>( new_node.nodeDataModel() );
@@ -638,7 +1093,7 @@ void GraphicContainer::recursiveLoadStep(QPointF& cursor,
     abs_node->graphic_node = &new_node;
 
     // Special case for node Subtree. Expand if necessary
-    if( abs_node->model.type == NodeType::SUBTREE &&
+    if( abs_node->model->type == NodeType::SUBTREE &&
             abs_node->children_index.size() == 1 )
     {
         if( auto subtree_node = dynamic_cast<SubtreeNodeModel*>( bt_node ) )
@@ -666,7 +1121,14 @@ void GraphicContainer::recursiveLoadStep(QPointF& cursor,
 void GraphicContainer::loadSceneFromTree(const AbsBehaviorTree &tree)
 {
     AbsBehaviorTree abs_tree = tree;
+
+    // no widgets yet, the visible nodes get them by updateNodeWidgets()
+    const PaintedByDefaultScope painted_scope( BehaviorTreeDataModel::paintedByDefault() ||
+                                               tree.nodesCount() > VIRTUALIZATION_THRESHOLD );
+
+    QtNodes::FlowSceneBatch batch( *_scene );
     _scene->clearScene();
+    _scene->setGraphicsOnDemand( tree.nodesCount() > VIRTUALIZATION_THRESHOLD );
 
     auto& first_qt_node = _scene->createNodeAtPos( "Root", "Root", QPointF(0,0) );
 
@@ -677,7 +1139,7 @@ void GraphicContainer::loadSceneFromTree(const AbsBehaviorTree &tree)
 
     auto root_node = abs_tree.rootNode();
 
-    if( root_node->model.registration_ID == "Root" )
+    if( root_node->model->registration_ID == "Root" )
     {
         root_node->graphic_node = &first_qt_node;
         int root_child_index = root_node->children_index.front();
@@ -686,11 +1148,15 @@ void GraphicContainer::loadSceneFromTree(const AbsBehaviorTree &tree)
 
     recursiveLoadStep(cursor, abs_tree, root_node, &first_qt_node, 1 );
     NodeReorder( *_scene, abs_tree );
+
+    paintLargeTree();
+    batch.commit();
 }
 
 void GraphicContainer::appendTreeToNode(Node &node, AbsBehaviorTree& subtree)
 {
     const QSignalBlocker blocker( this );
+    QtNodes::FlowSceneBatch batch( *_scene );
 
     for (auto& abs_node: subtree.nodes() )
     {
@@ -702,7 +1168,7 @@ void GraphicContainer::appendTreeToNode(Node &node, AbsBehaviorTree& subtree)
 
     auto root_node = subtree.rootNode();
 
-    if( root_node->model.registration_ID == "Root" )
+    if( root_node->model->registration_ID == "Root" )
     {
         if( root_node->children_index.size() == 1)
         {
@@ -713,18 +1179,130 @@ void GraphicContainer::appendTreeToNode(Node &node, AbsBehaviorTree& subtree)
         else{
             // Root has no child. Stop
             //  qDebug() << "Error: can't expand empty subtree";
+            batch.commit();
             return;
         }
     }
 
     recursiveLoadStep(cursor, subtree, root_node , &node, 1 );
+    batch.commit();
 }
 
 void GraphicContainer::loadFromJson(const QByteArray &data)
 {
     const QSignalBlocker blocker( this );
-    clearScene();
-    scene()->loadFromMemory( data );
+
+    // most likely, a large tree is replaced by another one, e.g. by undo
+    const bool large = _scene->nodes().size() > VIRTUALIZATION_THRESHOLD;
+    {
+        const PaintedByDefaultScope painted_scope( BehaviorTreeDataModel::paintedByDefault() || large );
+        clearScene();
+        _scene->setGraphicsOnDemand( large );
+        scene()->loadFromMemory( data );
+    }
+    paintLargeTree();
+}
+
+void GraphicContainer::loadFromBinary(const QByteArray &data)
+{
+    const QSignalBlocker blocker( this );
+
+    // see loadFromJson()
+    const bool large = _scene->nodes().size() > VIRTUALIZATION_THRESHOLD;
+    {
+        const PaintedByDefaultScope painted_scope( BehaviorTreeDataModel::paintedByDefault() || large );
+        clearScene();
+        _scene->setGraphicsOnDemand( large );
+        scene()->loadFromBinary( data );
+    }
+    paintLargeTree();
+}
+
+void GraphicContainer::patchFromBinary(const std::map<QUuid, QByteArray> &node_states)
+{
+    const QSignalBlocker blocker( this );
+    const auto& nodes = _scene->nodes();
+
+    std::map<QUuid, std::vector<QJsonObject>> wanted_connections;
+
+    // create or update the nodes first, they might be the ends of the connections
+    for (const auto& it: node_states)
+    {
+        QJsonObject node_json;
+        if( it.second.isEmpty() ||
+            !FlowScene::readNodeFromBinary( it.second, node_json, wanted_connections[it.first] ) )
+        {
+            continue;
+        }
+        const QString model_name = node_json["model"].toObject()["name"].toString();
+
+        auto node_it = nodes.find( it.first );
+        if( node_it != nodes.end() && node_it->second->nodeDataModel()->name() != model_name )
+        {
+            _scene->removeNode( *node_it->second );
+            node_it = nodes.end();
+        }
+
+        if( node_it == nodes.end() )
+        {
+            _scene->restoreNode( node_json );
+        }
+        else{
+            node_it->second->restore( node_json );
+        }
+    }
+
+    // then the connections entering each of them
+    for (auto& it: wanted_connections)
+    {
+        auto node_it = nodes.find( it.first );
+        if( node_it == nodes.end() )
+        {
+            continue;
+        }
+        std::vector<QJsonObject>& missing_connections = it.second;
+        std::vector<Connection*> extra_connections;
+
+        for (const auto& port_connections: node_it->second->nodeState().getEntries(PortType::In))
+        {
+            for (const auto& conn_it: port_connections)
+            {
+                const QJsonObject connection_json = conn_it.second->save();
+                bool wanted = false;
+                for (auto missing_it = missing_connections.begin();
+                     missing_it != missing_connections.end(); missing_it++)
+                {
+                    if( *missing_it == connection_json )
+                    {
+                        missing_connections.erase( missing_it );
+                        wanted = true;
+                        break;
+                    }
+                }
+                if( !wanted )
+                {
+                    extra_connections.push_back( conn_it.second );
+                }
+            }
+        }
+        for (Connection* connection: extra_connections)
+        {
+            _scene->deleteConnection( *connection );
+        }
+        for (const auto& connection_json: missing_connections)
+        {
+            _scene->restoreConnection( connection_json );
+        }
+    }
+
+    for (const auto& it: node_states)
+    {
+        auto node_it = nodes.find( it.first );
+        if( it.second.isEmpty() && node_it != nodes.end() )
+        {
+            _scene->removeNode( *node_it->second );
+        }
+    }
 }
 
 
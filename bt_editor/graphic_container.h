@@ -4,6 +4,9 @@
 #include <QObject>
 #include <QWidget>
 #include <QLineEdit>
+#include <QTimer>
+#include <set>
+#include <unordered_map>
 
 #include "bt_editor_base.h"
 #include "editor_flowscene.h"
@@ -13,6 +16,8 @@
 #include <nodes/FlowScene>
 #include <nodes/DataModelRegistry>
 #include <nodes/FlowView>
+#include <nodes/NodeStyle>
+#include <nodes/ConnectionStyle>
 
 class GraphicContainer : public QObject
 {
@@ -29,6 +34,26 @@ public:
 
     void lockEditing(bool locked);
 
+    // The editable trees with more nodes than this are painted: their fields
+    // are edited one at a time, see editPaintedField(). Only the nodes that
+    // can't be edited that way and are close to the visible area have widgets.
+    static const int VIRTUALIZATION_THRESHOLD = 1000;
+
+    // Nodes of a tree larger than VIRTUALIZATION_THRESHOLD that have a graphics
+    // object, at most, the closest to the visible area first. The scene paints
+    // the others, see QtNodes::FlowScene::setGraphicsOnDemand().
+    static const int MAX_NODE_GRAPHICS = 500;
+
+    // Give graphics objects to the nodes of a large tree near the visible area,
+    // and widgets at full detail, and destroy the ones of the other nodes.
+    // Done automatically when the view is panned or zoomed, and when the
+    // scene changes.
+    void updateNodeWidgets();
+
+    // Show a line edit over the painted field of the node at scene_pos,
+    // the only widget of the node. Return false if there is no such field.
+    bool editPaintedField(QtNodes::Node& node, const QPointF& scene_pos);
+
     void lockSubtreeEditing(QtNodes::Node& node, bool locked, bool change_style);
 
     void nodeReorder();
@@ -39,7 +64,11 @@ public:
 
     void clearScene();
 
-    AbsBehaviorTree loadedTree() const;
+    // The tree is built from the scene when nodes or connections change.
+    // Otherwise only the nodes touched since the last call are updated,
+    // unless that changes the order of some children.
+    // The reference is valid until the next change.
+    const AbsBehaviorTree& loadedTree() const;
 
     void loadSceneFromTree(const AbsBehaviorTree &tree);
 
@@ -47,6 +76,27 @@ public:
 
     void loadFromJson(const QByteArray& data);
 
+    // See FlowScene::saveToBinary()
+    void loadFromBinary(const QByteArray& data);
+
+    // Update only the given nodes, keeping all the others (and their widgets)
+    // alive. Each state is the output of FlowScene::saveNodeToBinary();
+    // an empty one means that the node must be removed.
+    void patchFromBinary(const std::map<QUuid, QByteArray>& node_states);
+
+    // Style of the node and of the connection to its parent. Nothing is
+    // repainted if they didn't change; otherwise all the nodes changed
+    // within the same frame are repainted together.
+    void applyNodeStyle(QtNodes::Node& node,
+                        const QtNodes::NodeStyle& node_style,
+                        const QtNodes::ConnectionStyle& conn_style);
+
+    // Repaint now the nodes restyled since the last frame
+    void flushStyleUpdates();
+
+    // Nodes waiting for the next flushStyleUpdates()
+    size_t pendingStyleUpdates() const { return _restyled_nodes.size(); }
+
     QtNodes::Node* substituteNode(QtNodes::Node* old_node, const QString& new_node_ID);
 
     void deleteSubTreeRecursively(QtNodes::Node& node);
@@ -57,7 +107,7 @@ public:
 
 public slots:
 
-    void onNodeDoubleClicked(QtNodes::Node& root_node);
+    void onNodeDoubleClicked(QtNodes::Node& root_node, const QPointF& scene_pos);
 
     void onPortValueDoubleClicked(QLineEdit* edit_value);
 
@@ -90,6 +140,22 @@ private:
 
    void insertNodeInConnection(QtNodes::Connection &connection, QString node_name);
 
+   // Paint all the nodes of a large editable tree, just loaded:
+   // updateNodeWidgets() gives widgets to the visible ones that need them,
+   // and graphics objects to the visible ones of any large tree
+   void paintLargeTree();
+
+   // The part of updateNodeWidgets() about the graphics objects
+   void updateNodeGraphics(const QRectF& area);
+
+   // Apply the state given by lockEditing() and lockSubtreeEditing(),
+   // kept by the model, to the graphics object of the node
+   void lockNodeGraphics(QtNodes::Node& node);
+
+   // Update the given nodes of _cached_tree from the scene. Return false
+   // if the order of some children changed: the tree must be built again.
+   bool patchLoadedTree(const std::set<QUuid>& touched_nodes) const;
+
    void recursiveLoadStep(QPointF &cursor, AbsBehaviorTree &tree,
                           AbstractTreeNode *abs_node,
                           QtNodes::Node* parent_node, int nest_level);
@@ -98,6 +164,24 @@ private:
 
    bool _signal_was_blocked;
 
+   mutable AbsBehaviorTree _cached_tree;
+   mutable quint64 _cached_tree_revision;
+   mutable quint64 _cached_tree_topology;
+   mutable QtNodes::PortLayout _cached_tree_layout;
+   // index in _cached_tree of each node of the scene
+   mutable std::unordered_map<QUuid, int> _cached_tree_index;
+   mutable bool _cached_validity;
+   mutable quint64 _cached_validity_revision;
+
+   std::set<QUuid> _restyled_nodes;
+   QTimer _restyle_timer;
+
+   bool _editing_locked;
+   // topology of the scene when lockEditing() was applied
+   quint64 _locked_topology_revision;
+   bool _widgets_virtualized;
+   QTimer _widgets_timer;
+
 };
 
 #endif // GRAPHIC_CONTAINER_H
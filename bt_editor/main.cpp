@@ -1,15 +1,18 @@
 #include <QCommandLineParser>
 #include <QApplication>
 #include <QDialog>
+#include <QSettings>
 #include <nodes/NodeStyle>
 #include <nodes/FlowViewStyle>
 #include <nodes/ConnectionStyle>
 #include <nodes/DataModelRegistry>
+#include <nodes/FlowView>
 
 #include "mainwindow.h"
 #include "XML_utilities.hpp"
 #include "startup_dialog.h"
 #include "models/RootNodeModel.hpp"
+#include "models/NodesStyle.hpp"
 
 using QtNodes::DataModelRegistry;
 using QtNodes::FlowViewStyle;
@@ -39,8 +42,29 @@ main(int argc, char *argv[])
                                    "Start in one of these modes: [editor,monitor,replay]",
                                    "mode");
     parser.addOption(mode_option);
+
+    QCommandLineOption nodes_style_option(QStringList() << "nodes-style",
+                                          "Style of the nodes, instead of the builtin NodesStyle.json. "
+                                          "It is reloaded when the file changes",
+                                          "file");
+    parser.addOption(nodes_style_option);
+
+    QCommandLineOption opengl_option(QStringList() << "opengl",
+                                     "Draw the trees with OpenGL and multisampling. "
+                                     "Also enabled by the setting FlowView/opengl");
+    parser.addOption(opengl_option);
     parser.process( app );
 
+    if( parser.isSet(nodes_style_option) )
+    {
+        NodesStyle::instance().setStyleFile( parser.value(nodes_style_option) );
+    }
+
+    if( parser.isSet(opengl_option) || QSettings().value("FlowView/opengl", false).toBool() )
+    {
+        QtNodes::FlowView::setOpenGLByDefault( true );
+    }
+
     QFile styleFile( ":/stylesheet.qss" );
     styleFile.open( QFile::ReadOnly );
     QString style( styleFile.readAll() );
@@ -42,7 +42,8 @@ MainWindow::MainWindow(GraphicMode initial_mode, QWidget *parent) :
                                                                     QMainWindow(parent),
                                                                     ui(new Ui::MainWindow),
                                                                     _current_mode(initial_mode),
-                                                                    _current_layout(QtNodes::PortLayout::Vertical)
+                                                                    _current_layout(QtNodes::PortLayout::Vertical),
+                                                                    _comparison_container(nullptr)
 {
     ui->setupUi(this);
 
@@ -70,10 +71,11 @@ MainWindow::MainWindow(GraphicMode initial_mode, QWidget *parent) :
         {
             category = "Root";
         }
+        auto model_ptr = std::make_shared<const NodeModel>( model );
         QtNodes::DataModelRegistry::RegistryItemCreator creator;
-        creator = [model]() -> QtNodes::DataModelRegistry::RegistryItemPtr
+        creator = [model_ptr]() -> QtNodes::DataModelRegistry::RegistryItemPtr
         {
-            auto ptr = new BehaviorTreeDataModel( model );
+            auto ptr = new BehaviorTreeDataModel( model_ptr );
             return std::unique_ptr<BehaviorTreeDataModel>(ptr);
         };
         _model_registry->registerModel( category, creator, ID );
@@ -189,6 +191,15 @@ MainWindow::MainWindow(GraphicMode initial_mode, QWidget *parent) :
     connect( _replay_widget, &SidepanelReplay::changeNodeStyle,
             this, &MainWindow::onChangeNodesStatus);
 
+    connect( _replay_widget, &SidepanelReplay::loadComparisonTree,
+            this, &MainWindow::onLoadComparisonTree);
+
+    connect( _replay_widget, &SidepanelReplay::changeComparisonNodeStyle,
+            this, &MainWindow::onChangeComparisonStatus);
+
+    connect( _replay_widget, &SidepanelReplay::comparisonClosed,
+            this, &MainWindow::onComparisonClosed);
+
 #ifdef ZMQ_FOUND
 
     connect( _monitor_widget, &SidepanelMonitor::addNewModel,
@@ -208,7 +219,8 @@ MainWindow::MainWindow(GraphicMode initial_mode, QWidget *parent) :
     createTab("BehaviorTree");
     onTabSetMainTree(0);
     onSceneChanged();
-    _current_state = saveCurrentState();
+    onPushUndo();
+    _undo_history.clearStacks();
 
     refreshComboBoxSubtreesFilter();
 }
@@ -348,7 +360,7 @@ void MainWindow::loadFromXML(const QString& xml_text)
     //---------------
     bool error = false;
     QString err_message;
-    auto saved_state = _current_state;
+    const UndoSnapshot saved_state = _undo_history.current();
     auto prev_tree_model = _treenode_models;
 
     try {
@@ -432,8 +444,19 @@ void MainWindow::loadFromXML(const QString& xml_text)
     if( error )
     {
         _treenode_models = prev_tree_model;
-        loadSavedStateFromJson( saved_state );
-        qDebug() << "R: Undo size: " << _undo_stack.size() << " Redo size: " << _redo_stack.size();
+
+        std::set<QString> tab_names;
+        for (const auto& it: _tab_info)
+        {
+            tab_names.insert( it.first );
+        }
+        for (const auto& it: saved_state.tabs)
+        {
+            tab_names.insert( it.first );
+        }
+        // the commands pushed while loading refer to trees that don't exist anymore
+        _undo_history.reset( saved_state );
+        restoreSavedState( tab_names );
         QMessageBox::warning(this, tr("Exception!"),
                              tr("It was not possible to parse the file. Error:\n\n%1"). arg( err_message ),
                              QMessageBox::Ok);
@@ -507,10 +530,10 @@ QString MainWindow::saveToXML() const
         auto& container = it.second;
         auto  scene = container->scene();
 
-        auto abs_tree = BuildTreeFromScene(container->scene());
+        const auto& abs_tree = container->loadedTree();
         auto abs_root = abs_tree.rootNode();
         if( abs_root->children_index.size() == 1 &&
-            abs_root->model.registration_ID == "Root"  )
+            abs_root->model->registration_ID == "Root"  )
         {
             // mofe to the child of ROOT
             abs_root = abs_tree.node( abs_root->children_index.front() );
@@ -698,50 +721,82 @@ void MainWindow::on_splitter_splitterMoved(int , int )
     }
 }
 
-MainWindow::SavedState MainWindow::saveCurrentState()
+UndoView MainWindow::currentUndoView()
 {
-    SavedState saved;
+    UndoView view;
     int index = ui->tabWidget->currentIndex();
-    saved.main_tree = _main_tree;
-    saved.current_tab_name = ui->tabWidget->tabText(index);
-    auto current_view = getTabByName( saved.current_tab_name )->view();
-    saved.view_transform = current_view->transform();
-    saved.view_area = current_view->sceneRect();
-
-    for (auto& it: _tab_info)
+    view.main_tree = _main_tree;
+    view.current_tab_name = ui->tabWidget->tabText(index);
+    if( auto current_tab = getTabByName( view.current_tab_name ) )
     {
-        saved.json_states[it.first] = it.second->scene()->saveToMemory();
+        view.view_transform = current_tab->view()->transform();
+        view.view_area = current_tab->view()->sceneRect();
     }
-    return saved;
+    return view;
 }
 
 void MainWindow::onPushUndo()
 {
-    SavedState saved = saveCurrentState();
+    UndoChanges changes;
+    changes.view = currentUndoView();
+
+    for (auto& it: _tab_info)
+    {
+        const QString& name = it.first;
+        GraphicContainer* container = it.second;
+        auto scene = container->scene();
+
+        auto& tab_changes = changes.tabs[name];
+        tab_changes.layout = scene->layout();
+
+        const auto touched_nodes = scene->takeTouchedNodes();
+        const auto& scene_nodes = scene->nodes();
+
+        // a new tab, or a tab replaced by another one with the same name
+        auto& known_container = _undo_tabs[name];
+        if( known_container != container )
+        {
+            known_container = container;
+            tab_changes.complete = true;
+            for (const auto& node_it: scene_nodes)
+            {
+                tab_changes.nodes[node_it.first] = FlowScene::saveNodeToBinary( *node_it.second );
+            }
+            continue;
+        }
+
+        for (const QUuid& id: touched_nodes)
+        {
+            auto node_it = scene_nodes.find( id );
+            tab_changes.nodes[id] = ( node_it != scene_nodes.end() ) ?
+                        FlowScene::saveNodeToBinary( *node_it->second ) : QByteArray();
+        }
+    }
 
-    if( _undo_stack.empty() || ( saved != _current_state &&  _undo_stack.back() != _current_state) )
+    for (auto it = _undo_tabs.begin(); it != _undo_tabs.end(); )
     {
-        _undo_stack.push_back( std::move(_current_state) );
-        _redo_stack.clear();
+        if( _tab_info.count( it->first ) == 0 ) {
+            it = _undo_tabs.erase( it );
+        }
+        else{
+            it++;
+        }
     }
-    _current_state = saved;
 
-    //qDebug() << "P: Undo size: " << _undo_stack.size() << " Redo size: " << _redo_stack.size();
+    _undo_history.push( changes );
+
+    //qDebug() << "P: Undo size: " << _undo_history.undoSize() << " Redo size: " << _undo_history.redoSize();
 }
 
 void MainWindow::onUndoInvoked()
 {
     if ( _current_mode != GraphicMode::EDITOR ) return; //locked
 
-    if( _undo_stack.size() > 0)
+    if( auto command = _undo_history.undo() )
     {
-        _redo_stack.push_back( std::move(_current_state) );
-        _current_state = _undo_stack.back();
-        _undo_stack.pop_back();
-
-        loadSavedStateFromJson(_current_state);
+        applyUndoCommand( *command, false );
 
-        // qDebug() << "U: Undo size: " << _undo_stack.size() << " Redo size: " << _redo_stack.size();
+        // qDebug() << "U: Undo size: " << _undo_history.undoSize() << " Redo size: " << _undo_history.redoSize();
     }
 }
 
@@ -749,48 +804,87 @@ void MainWindow::onRedoInvoked()
 {
     if ( _current_mode != GraphicMode::EDITOR ) return; //locked
 
-    if( _redo_stack.size() > 0)
+    if( auto command = _undo_history.redo() )
     {
-        _undo_stack.push_back( _current_state );
-        _current_state = std::move( _redo_stack.back() );
-        _redo_stack.pop_back();
-
-        loadSavedStateFromJson(_current_state);
+        applyUndoCommand( *command, true );
 
-        // qDebug() << "R: Undo size: " << _undo_stack.size() << " Redo size: " << _redo_stack.size();
+        // qDebug() << "R: Undo size: " << _undo_history.undoSize() << " Redo size: " << _undo_history.redoSize();
     }
 }
 
-void MainWindow::loadSavedStateFromJson(SavedState saved_state)
+void MainWindow::applyUndoCommand(const UndoCommand &command, bool forward)
 {
-    // TODO crash if the name of the container (tab) changed
-    for (auto& it: _tab_info)
+    // tabs created, removed or with a different layout are loaded from scratch
+    std::set<QString> reloaded_tabs;
+    for (const auto& tab: command.tabs)
     {
-        it.second->clearScene();
-        it.second->deleteLater();
+        reloaded_tabs.insert( tab.name );
     }
-    _tab_info.clear();
-    ui->tabWidget->clear();
 
-    _main_tree = saved_state.main_tree;
+    std::map<QString, std::map<QUuid, QByteArray>> node_states;
+    for (const auto& change: command.nodes)
+    {
+        if( reloaded_tabs.count( change.tab ) == 0 )
+        {
+            node_states[change.tab][change.id] = forward ? change.after : change.before;
+        }
+    }
 
-    for(const auto& it: saved_state.json_states)
+    for (const auto& it: node_states)
     {
-        QString tab_name = it.first;
-        _tab_info.insert( {tab_name, createTab(tab_name)} );
+        auto container = getTabByName( it.first );
+        if( !container )
+        {
+            reloaded_tabs.insert( it.first );
+            continue;
+        }
+        container->patchFromBinary( it.second );
+        container->scene()->takeTouchedNodes();
     }
-    for(const auto& it: saved_state.json_states)
+
+    restoreSavedState( reloaded_tabs );
+}
+
+void MainWindow::restoreSavedState(const std::set<QString>& tab_names)
+{
+    const UndoSnapshot& saved_state = _undo_history.current();
+
+    _main_tree = saved_state.view.main_tree;
+
+    for (const QString& name: tab_names)
     {
-        QString name = it.first;
         auto container = getTabByName(name);
-        container->loadFromJson( it.second );
-        container->view()->setTransform( saved_state.view_transform );
-        container->view()->setSceneRect( saved_state.view_area );
+        auto saved_tab = saved_state.tabs.find(name);
+
+        if( saved_tab == saved_state.tabs.end() )
+        {
+            if( container )
+            {
+                container->clearScene();
+                container->deleteLater();
+                ui->tabWidget->removeTab( ui->tabWidget->indexOf( container->view() ) );
+                _tab_info.erase( name );
+                _undo_tabs.erase( name );
+            }
+            continue;
+        }
+
+        if( !container )
+        {
+            container = createTab(name);
+        }
+        container->loadFromBinary( saved_tab->second.toBinary() );
+        container->view()->setTransform( saved_state.view.view_transform );
+        container->view()->setSceneRect( saved_state.view.view_area );
+
+        // the scene is now equal to the saved state
+        container->scene()->takeTouchedNodes();
+        _undo_tabs[name] = container;
     }
 
     for (int i=0; i< ui->tabWidget->count(); i++)
     {
-        if( ui->tabWidget->tabText( i ) == saved_state.current_tab_name)
+        if( ui->tabWidget->tabText( i ) == saved_state.view.current_tab_name)
         {
             ui->tabWidget->setCurrentIndex(i);
             ui->tabWidget->widget(i)->setFocus();
@@ -850,13 +944,16 @@ void MainWindow::onAddToModelRegistry(const NodeModel &model)
     namespace util = QtNodes::detail;
     const auto& ID = model.registration_ID;
 
-    DataModelRegistry::RegistryItemCreator node_creator = [model]() -> DataModelRegistry::RegistryItemPtr
+    // all the nodes created by the registry share the same copy of the model
+    auto model_ptr = std::make_shared<const NodeModel>( model );
+
+    DataModelRegistry::RegistryItemCreator node_creator = [model_ptr]() -> DataModelRegistry::RegistryItemPtr
     {
-        if( model.type == NodeType::SUBTREE)
+        if( model_ptr->type == NodeType::SUBTREE)
         {
-            return util::make_unique<SubtreeNodeModel>(model);
+            return util::make_unique<SubtreeNodeModel>(model_ptr);
         }
-        return util::make_unique<BehaviorTreeDataModel>(model);
+        return util::make_unique<BehaviorTreeDataModel>(model_ptr);
     };
 
     _model_registry->registerModel( QString::fromStdString( toStr(model.type)), node_creator, ID);
@@ -882,7 +979,7 @@ void MainWindow::onDestroySubTree(const QString &ID)
             continue;
         }
         auto container = it.second;
-        auto tree = BuildTreeFromScene(container->scene());
+        auto tree = container->loadedTree();
         for( const auto& abs_node: tree.nodes())
         {
             auto qt_node = abs_node.graphic_node;
@@ -1031,7 +1128,7 @@ QtNodes::Node* MainWindow::subTreeExpand(GraphicContainer &container,
             return &node;
         }
 
-        auto abs_subtree = BuildTreeFromScene( subtree_container->scene() );
+        auto abs_subtree = subtree_container->loadedTree();
 
         subtree_model->setExpanded(true);
         node.nodeState().getEntries(PortType::Out).resize(1);
@@ -1087,7 +1184,7 @@ QtNodes::Node* MainWindow::subTreeExpand(GraphicContainer &container,
         QtNodes::Node* child_node = conn_out.begin()->second->getNode( PortType::In );
 
         auto subtree_container = getTabByName(subtree_name);
-        auto subtree = BuildTreeFromScene( subtree_container->scene() );
+        auto subtree = subtree_container->loadedTree();
 
         container.deleteSubTreeRecursively( *child_node );
         container.appendTreeToNode( node, subtree );
@@ -1112,8 +1209,7 @@ void MainWindow::on_toolButtonCenterView_pressed()
 
 void MainWindow::clearUndoStacks()
 {
-    _undo_stack.clear();
-    _redo_stack.clear();
+    _undo_history.clearStacks();
     onSceneChanged();
     onPushUndo();
 }
@@ -1134,9 +1230,9 @@ void MainWindow::onCreateAbsBehaviorTree(const AbsBehaviorTree &tree,
     if( secondary_tabs ){
       for(const auto& node: tree.nodes())
       {
-        if( node.model.type == NodeType::SUBTREE && getTabByName(node.model.registration_ID) == nullptr)
+        if( node.model->type == NodeType::SUBTREE && getTabByName(node.model->registration_ID) == nullptr)
         {
-          createTab(node.model.registration_ID);
+          createTab(node.model->registration_ID);
         }
       }
     }
@@ -1278,6 +1374,7 @@ void MainWindow::updateCurrentMode()
         connect( ui->toolButtonLoadFile, &QToolButton::clicked,
                 _replay_widget, &SidepanelReplay::on_LoadLog );
     }
+    BehaviorTreeDataModel::setPaintedByDefault( NOT_EDITOR );
     lockEditing( NOT_EDITOR );
 
     if( _current_mode == GraphicMode::EDITOR)
@@ -1313,7 +1410,7 @@ void MainWindow::refreshNodesLayout(QtNodes::PortLayout new_layout)
             auto scene = tab.second->scene();
             if( scene->layout() != new_layout )
             {
-                auto abstract_tree = BuildTreeFromScene( scene );
+                auto abstract_tree = tab.second->loadedTree();
                 scene->setLayout( new_layout );
                 NodeReorder( *scene, abstract_tree );
                 refreshed = true;
@@ -1454,61 +1551,31 @@ void MainWindow::on_tabWidget_currentChanged(int index)
     {
         const QSignalBlocker blocker( tab );
         tab->nodeReorder();
-        _current_state.current_tab_name = ui->tabWidget->tabText( index );
         refreshExpandedSubtrees();
         tab->zoomHomeView();
     }
 }
 
-bool MainWindow::SavedState::operator ==(const MainWindow::SavedState &other) const
-{
-    if( current_tab_name != other.current_tab_name ||
-        json_states.size() != other.json_states.size())
-    {
-        return false;
-    }
-    for(auto& it: json_states  )
-    {
-        auto other_it = other.json_states.find(it.first);
-        if( other_it == other.json_states.end() ||
-            it.second != other_it->second)
-        {
-            return false;
-        }
-    }
-    if( view_area != other.view_area ||
-        view_transform != other.view_transform)
-    {
-        return false;
-    }
-    return true;
-}
-
-void MainWindow::resetTreeStyle(AbsBehaviorTree &tree){
+void MainWindow::resetTreeStyle(GraphicContainer* container){
     //printf("resetTreeStyle\n");
-    QtNodes::NodeStyle  node_style;
-    QtNodes::ConnectionStyle conn_style;
-
-    for(auto abs_node: tree.nodes()){
-        auto gui_node = abs_node.graphic_node;
+    const QtNodes::NodeStyle  node_style;
+    const QtNodes::ConnectionStyle conn_style;
 
-        gui_node->nodeDataModel()->setNodeStyle( node_style );
-        gui_node->nodeGraphicsObject().update();
-
-        const auto& conn_in = gui_node->nodeState().connections(PortType::In, 0 );
-        if(conn_in.size() == 1)
-        {
-            auto conn = conn_in.begin()->second;
-            conn->setStyle( conn_style );
-            conn->connectionGraphicsObject().update();
-        }
+    for(const auto& abs_node: container->loadedTree().nodes()){
+        container->applyNodeStyle( *abs_node.graphic_node, node_style, conn_style );
     }
 }
 
 void MainWindow::onChangeNodesStatus(const QString& bt_name,
                                      const std::vector<std::pair<int, NodeStatus> > &node_status)
 {
-    auto tree = BuildTreeFromScene( getTabByName(bt_name)->scene() );
+    applyNodesStatus( getTabByName(bt_name), node_status );
+}
+
+void MainWindow::applyNodesStatus(GraphicContainer* container,
+                                  const std::vector<std::pair<int, NodeStatus> > &node_status)
+{
+    const auto& tree = container->loadedTree();
 
     std::vector<NodeStatus> vec_last_status(tree.nodesCount());
 
@@ -1523,22 +1590,54 @@ void MainWindow::onChangeNodesStatus(const QString& bt_name,
         // printf("%3d: %d, %s\n", index, (int)it.second, abs_node.instance_name.toStdString().c_str());
 
         if(index == 1 && it.second == NodeStatus::RUNNING)
-            resetTreeStyle(tree);
+            resetTreeStyle(container);
 
-        auto gui_node = abs_node.graphic_node;
         auto style = getStyleFromStatus( status, vec_last_status[index] );
-        gui_node->nodeDataModel()->setNodeStyle( style.first );
-        gui_node->nodeGraphicsObject().update();
+        container->applyNodeStyle( *abs_node.graphic_node, style.first, style.second );
 
         vec_last_status[index] = status;
+    }
+}
 
-        const auto& conn_in = gui_node->nodeState().connections(PortType::In, 0 );
-        if(conn_in.size() == 1)
-        {
-            auto conn = conn_in.begin()->second;
-            conn->setStyle( style.second );
-            conn->connectionGraphicsObject().update();
-        }
+void MainWindow::onLoadComparisonTree(const AbsBehaviorTree &tree, const QString &name)
+{
+    if( !_comparison_container )
+    {
+        // not part of _tab_info: it is never edited nor saved
+        _comparison_container = new GraphicContainer( _model_registry, this );
+        ui->splitter->addWidget( _comparison_container->view() );
+        ui->splitter->setStretchFactor( 2, 4 );
+    }
+    auto main_container = getTabByName("BehaviorTree");
+    if( main_container )
+    {
+        _comparison_container->scene()->setLayout( main_container->scene()->layout() );
+    }
+
+    const QSignalBlocker blocker( _comparison_container );
+    _comparison_container->loadSceneFromTree( tree );
+    _comparison_container->nodeReorder();
+    _comparison_container->lockEditing( true );
+    _comparison_container->view()->setToolTip( name );
+    _comparison_container->view()->show();
+    _comparison_container->zoomHomeView();
+}
+
+void MainWindow::onChangeComparisonStatus(const std::vector<std::pair<int, NodeStatus> > &node_status)
+{
+    if( _comparison_container && _comparison_container->view()->isVisible() )
+    {
+        applyNodesStatus( _comparison_container, node_status );
+    }
+}
+
+void MainWindow::onComparisonClosed()
+{
+    if( _comparison_container )
+    {
+        const QSignalBlocker blocker( _comparison_container );
+        _comparison_container->clearScene();
+        _comparison_container->view()->hide();
     }
 }
 
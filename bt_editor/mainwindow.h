@@ -7,6 +7,7 @@
 #include <QTreeWidgetItem>
 #include <QShortcut>
 #include <QTimer>
+#include <QPointer>
 #include <deque>
 #include <thread>
 #include <mutex>
@@ -16,6 +17,7 @@
 #include "XML_utilities.hpp"
 #include "sidepanel_editor.h"
 #include "sidepanel_replay.h"
+#include "undo_history.h"
 #include "models/SubtreeNodeModel.hpp"
 
 #ifdef ZMQ_FOUND
@@ -58,7 +60,7 @@ public:
 
     const NodeModels &registeredModels() const;
 
-    void resetTreeStyle(AbsBehaviorTree &tree);
+    void resetTreeStyle(GraphicContainer* container);
 
     GraphicMode getGraphicMode(void) const;
 
@@ -103,6 +105,12 @@ public slots:
 
     void onChangeNodesStatus(const QString& bt_name, const std::vector<std::pair<int, NodeStatus>>& node_status);
 
+    void onLoadComparisonTree(const AbsBehaviorTree& tree, const QString& name);
+
+    void onChangeComparisonStatus(const std::vector<std::pair<int, NodeStatus>>& node_status);
+
+    void onComparisonClosed();
+
     void on_toolButtonLayout_clicked();
 
     void on_actionEditor_mode_triggered();
@@ -163,18 +171,14 @@ private:
 
     void refreshComboBoxSubtreesFilter();
 
-    struct SavedState
-    {
-        QString main_tree;
-        QString current_tab_name;
-        QTransform view_transform;
-        QRectF view_area;
-        std::map<QString, QByteArray> json_states;
-        bool operator ==( const SavedState& other) const;
-        bool operator !=( const SavedState& other) const { return !( *this == other); }
-    };
+    void applyNodesStatus(GraphicContainer* container,
+                          const std::vector<std::pair<int, NodeStatus>>& node_status);
 
-    void loadSavedStateFromJson(SavedState state);
+    // Make the given tabs equal to the current state of the undo history
+    void restoreSavedState(const std::set<QString>& tab_names);
+
+    // Patch the scenes changed by an undo (forward = false) or a redo
+    void applyUndoCommand(const UndoCommand& command, bool forward);
 
     QtNodes::Node *subTreeExpand(GraphicContainer& container,
                        QtNodes::Node &node,
@@ -190,9 +194,9 @@ private:
 
     std::mutex _mutex;
 
-    std::deque<SavedState> _undo_stack;
-    std::deque<SavedState> _redo_stack;
-    SavedState _current_state;
+    UndoHistory _undo_history;
+    // container of each tab at the time of the last push
+    std::map<QString, QPointer<GraphicContainer>> _undo_tabs;
     QtNodes::PortLayout _current_layout;
 
     NodeModels _treenode_models;
@@ -201,11 +205,14 @@ private:
 
     SidepanelEditor* _editor_widget;
     SidepanelReplay* _replay_widget;
+
+    // second scene, used to replay another log side by side
+    GraphicContainer* _comparison_container;
 #ifdef ZMQ_FOUND
     SidepanelMonitor* _monitor_widget;
 #endif
     
-    MainWindow::SavedState saveCurrentState();
+    UndoView currentUndoView();
     void clearUndoStacks();
 };
 
@@ -9,21 +9,71 @@
 #include <QFont>
 #include <QApplication>
 #include <QJsonDocument>
+#include <QPainter>
+#include <cmath>
 
 const int MARGIN = 10;
 const int DEFAULT_LINE_WIDTH  = 100;
 const int DEFAULT_FIELD_WIDTH = 50;
 const int DEFAULT_LABEL_WIDTH = 50;
 
-BehaviorTreeDataModel::BehaviorTreeDataModel(const NodeModel &model):
+static bool painted_by_default = false;
+
+void BehaviorTreeDataModel::setPaintedByDefault(bool painted)
+{
+    painted_by_default = painted;
+}
+
+bool BehaviorTreeDataModel::paintedByDefault()
+{
+    return painted_by_default;
+}
+
+BehaviorTreeDataModel::BehaviorTreeDataModel(const NodeModelPtr &model):
     _params_widget(nullptr),
+    _line_edit_name(nullptr),
     _uid( GetUID() ),
+    _form_layout(nullptr),
+    _main_layout(nullptr),
+    _caption_label(nullptr),
+    _caption_logo_left(nullptr),
+    _caption_logo_right(nullptr),
     _model(model),
-    _icon_renderer(nullptr),
-    _style_caption_color( QtNodes::NodeStyle().FontColor ),
-    _style_caption_alias( model.registration_ID )
+    _locked(false),
+    _painted(painted_by_default),
+    _style( NodesStyle::instance().style( model->type, model->registration_ID ) )
+{
+    connect( &NodesStyle::instance(), &NodesStyle::styleChanged,
+             this, &BehaviorTreeDataModel::onStyleChanged );
+
+    for(const auto& port_it: model->ports )
+    {
+        _port_values.insert( {port_it.first, port_it.second.default_value} );
+    }
+}
+
+std::vector<QString> BehaviorTreeDataModel::orderedPorts() const
+{
+    std::vector<QString> ports;
+    ports.reserve( _model->ports.size() );
+
+    for(auto preferred_direction: { PortDirection::INPUT,
+                                    PortDirection::OUTPUT,
+                                    PortDirection::INOUT} )
+    {
+        for(const auto& port_it: _model->ports )
+        {
+            if( port_it.second.direction == preferred_direction )
+            {
+                ports.push_back( port_it.first );
+            }
+        }
+    }
+    return ports;
+}
+
+void BehaviorTreeDataModel::createWidgets()
 {
-    readStyle();
     _main_widget = new QFrame();
     _line_edit_name = new QLineEdit(_main_widget);
     _params_widget = new QFrame();
@@ -59,6 +109,7 @@ BehaviorTreeDataModel::BehaviorTreeDataModel(const NodeModel &model):
     //----------------------------
     _line_edit_name->setAlignment( Qt::AlignCenter );
     _line_edit_name->setText( _instance_name );
+    _line_edit_name->setHidden( !showsInstanceName() );
     _line_edit_name->setFixedWidth( DEFAULT_LINE_WIDTH );
 
     _main_widget->setAttribute(Qt::WA_NoSystemBackground);
@@ -78,86 +129,89 @@ BehaviorTreeDataModel::BehaviorTreeDataModel(const NodeModel &model):
     _form_layout->setVerticalSpacing(2);
     _form_layout->setContentsMargins(0, 0, 0, 0);
 
-    PortDirection preferred_port_types[3] = { PortDirection::INPUT,
-                                              PortDirection::OUTPUT,
-                                              PortDirection::INOUT};
-
-    for(int pref_index=0; pref_index < 3; pref_index++)
+    _ports_widgets.clear();
+    for(const auto& port_name: orderedPorts() )
     {
-        for(const auto& port_it: model.ports )
+        const auto& port = _model->ports.at( port_name );
+        const auto preferred_direction = port.direction;
+
+        QString description = port.description;
+        QString label = port_name;
+        if( preferred_direction == PortDirection::INPUT)
         {
-            auto preferred_direction = preferred_port_types[pref_index];
-            if( port_it.second.direction != preferred_direction )
+            label.prepend("[IN] ");
+            if( description.isEmpty())
             {
-                continue;
+                description="[INPUT]";
             }
-
-            QString description = port_it.second.description;
-            QString label = port_it.first;
-            if( preferred_direction == PortDirection::INPUT)
+            else{
+                description.prepend("[INPUT]: ");
+            }
+        }
+        else if( preferred_direction == PortDirection::OUTPUT){
+            label.prepend("[OUT] ");
+            if( description.isEmpty())
             {
-                label.prepend("[IN] ");
-                if( description.isEmpty())
-                {
-                    description="[INPUT]";
-                }
-                else{
-                    description.prepend("[INPUT]: ");
-                }
+                description="[OUTPUT]";
             }
-            else if( preferred_direction == PortDirection::OUTPUT){
-                label.prepend("[OUT] ");
-                if( description.isEmpty())
-                {
-                    description="[OUTPUT]";
-                }
-                else{
-                    description.prepend("[OUTPUT]: ");
-                }
+            else{
+                description.prepend("[OUTPUT]: ");
             }
+        }
 
-            GrootLineEdit* form_field = new GrootLineEdit();
-            form_field->setAlignment( Qt::AlignHCenter);
-            form_field->setMaximumWidth(140);
-            form_field->setText( port_it.second.default_value );
+        GrootLineEdit* form_field = new GrootLineEdit();
+        form_field->setAlignment( Qt::AlignHCenter);
+        form_field->setMaximumWidth(140);
+        form_field->setText( _port_values.at(port_name) );
 
-            connect(form_field, &GrootLineEdit::doubleClicked,
-                    this, [this,form_field]()
-                    { emit this->portValueDoubleChicked(form_field); });
+        connect(form_field, &GrootLineEdit::doubleClicked,
+                this, [this,form_field]()
+                { emit this->portValueDoubleChicked(form_field); });
 
-            connect(form_field, &GrootLineEdit::lostFocus,
-                    this, [this]()
-                    { emit this->portValueDoubleChicked(nullptr); });
+        connect(form_field, &GrootLineEdit::lostFocus,
+                this, [this]()
+                { emit this->portValueDoubleChicked(nullptr); });
 
-            QLabel* form_label  =  new QLabel( label, _params_widget );
-            form_label->setToolTip( description );
-            form_label->setStyleSheet("QToolTip {color: black; background-color: rgb(200,200,200); border: 0px;}" );
+        QLabel* form_label  =  new QLabel( label, _params_widget );
+        form_label->setToolTip( description );
+        form_label->setStyleSheet("QToolTip {color: black; background-color: rgb(200,200,200); border: 0px;}" );
 
-            form_field->setMinimumWidth(DEFAULT_FIELD_WIDTH);
+        form_field->setMinimumWidth(DEFAULT_FIELD_WIDTH);
 
-            _ports_widgets.insert( std::make_pair( port_it.first, form_field) );
+        _ports_widgets.insert( std::make_pair( port_name, form_field) );
 
-            form_field->setStyleSheet("color: rgb(30,30,30); "
-                                      "background-color: rgb(200,200,200); "
-                                      "border: 0px; ");
+        form_field->setStyleSheet("color: rgb(30,30,30); "
+                                  "background-color: rgb(200,200,200); "
+                                  "border: 0px; ");
 
-            _form_layout->addRow( form_label, form_field );
+        _form_layout->addRow( form_label, form_field );
 
-            auto paramUpdated = [this,label,form_field]()
-            {
-                this->parameterUpdated(label,form_field);
-            };
+        auto paramUpdated = [this,label,form_field]()
+        {
+            this->parameterUpdated(label,form_field);
+        };
 
-            if(auto lineedit = dynamic_cast<QLineEdit*>( form_field ) )
+        if(auto lineedit = dynamic_cast<QLineEdit*>( form_field ) )
+        {
+            connect( lineedit, &QLineEdit::editingFinished, this, paramUpdated );
+            connect( lineedit, &QLineEdit::editingFinished,
+                     this, &BehaviorTreeDataModel::updateNodeSize);
+            connect( lineedit, &QLineEdit::textChanged,
+                     this, [this, port_name](const QString& text)
             {
-                connect( lineedit, &QLineEdit::editingFinished, this, paramUpdated );
-                connect( lineedit, &QLineEdit::editingFinished,
-                         this, &BehaviorTreeDataModel::updateNodeSize);
-            }
-            else if( auto combo = dynamic_cast<QComboBox*>( form_field ) )
+                _port_values[port_name] = text;
+                emit portMappingChanged();
+            });
+        }
+        else if( auto combo = dynamic_cast<QComboBox*>( form_field ) )
+        {
+            connect( combo, &QComboBox::currentTextChanged, this, paramUpdated);
+            connect( combo, &QComboBox::currentTextChanged,
+                     this, [this, port_name](const QString& text)
             {
-                connect( combo, &QComboBox::currentTextChanged, this, paramUpdated);
-            }
+                _port_values[port_name] = text;
+                emit portMappingChanged();
+            });
         }
     }
     _params_widget->adjustSize();
@@ -171,44 +225,69 @@ BehaviorTreeDataModel::BehaviorTreeDataModel(const NodeModel &model):
     {
         setInstanceName( _line_edit_name->text() );
     });
+
+    lock( _locked );
+    onHighlightPortValue( _highlighted_value );
+    initWidget();
 }
 
 BehaviorTreeDataModel::~BehaviorTreeDataModel()
 {
+    if( _main_widget && !_main_widget->graphicsProxyWidget() )
+    {
+        delete _main_widget;
+    }
+}
+
+bool BehaviorTreeDataModel::resetToDefault()
+{
+    // the node and whoever was listening to it are gone
+    disconnect( this, nullptr, nullptr, nullptr );
+
+    resetNodeStyle();
+    // a new node, as far as the scene and the monitor know
+    _uid = GetUID();
+    _instance_name.clear();
+    if( _main_widget )
+    {
+        _line_edit_name->setText( _instance_name );
+    }
+    for(const auto& port_it: _model->ports )
+    {
+        setPortMapping( port_it.first, port_it.second.default_value );
+    }
+    onHighlightPortValue( QString() );
+    lock( false );
+    _painted_layout.valid = false;
+    return true;
+}
 
+void BehaviorTreeDataModel::prepareForReuse()
+{
+    // the mode may have changed while the model was in the pool
+    setPainted( painted_by_default );
 }
 
 BT::NodeType BehaviorTreeDataModel::nodeType() const
 {
-    return _model.type;
+    return _model->type;
 }
 
 void BehaviorTreeDataModel::initWidget()
 {
-    if( _style_icon.isEmpty() == false )
+    if( !_main_widget )
     {
-        _caption_logo_left->setFixedWidth( 20 );
-        _caption_logo_right->setFixedWidth( 1 );
-
-        QFile file(_style_icon);
-        if(!file.open(QIODevice::ReadOnly))
-        {
-            qDebug()<<"file not opened: "<< _style_icon;
-            file.close();
-        }
-        else {
-            QByteArray ba = file.readAll();
-            QByteArray new_color_fill = QString("fill:%1;").arg( _style_caption_color.name() ).toUtf8();
-            ba.replace("fill:#ffffff;", new_color_fill);
-            _icon_renderer =  new QSvgRenderer(ba, this);
-        }
+        updateNodeSize();
+        return;
     }
+    _caption_logo_left->setFixedWidth( _style->icon_renderer ? 20 : 0 );
+    _caption_logo_right->setFixedWidth( _style->icon_renderer ? 1 : 0 );
 
-    _caption_label->setText( _style_caption_alias );
+    _caption_label->setText( _style->caption_alias );
 
     QPalette capt_palette = _caption_label->palette();
     capt_palette.setColor(_caption_label->backgroundRole(), Qt::transparent);
-    capt_palette.setColor(_caption_label->foregroundRole(), _style_caption_color);
+    capt_palette.setColor(_caption_label->foregroundRole(), _style->caption_color);
     _caption_label->setPalette(capt_palette);
 
     _caption_logo_left->adjustSize();
@@ -232,18 +311,25 @@ unsigned int BehaviorTreeDataModel::nPorts(QtNodes::PortType portType) const
     }
     else if( portType == QtNodes::PortType::In )
     {
-        return (_model.registration_ID == "Root") ? 0 : 1;
+        return (_model->registration_ID == "Root") ? 0 : 1;
     }
     return 0;
 }
 
 NodeDataModel::ConnectionPolicy BehaviorTreeDataModel::portOutConnectionPolicy(QtNodes::PortIndex) const
 {
-    return ( nodeType() == NodeType::DECORATOR || _model.registration_ID == "Root") ? ConnectionPolicy::One : ConnectionPolicy::Many;
+    return ( nodeType() == NodeType::DECORATOR || _model->registration_ID == "Root") ? ConnectionPolicy::One : ConnectionPolicy::Many;
 }
 
 void BehaviorTreeDataModel::updateNodeSize()
 {
+    _painted_layout.valid = false;
+    if( !_main_widget )
+    {
+        emit embeddedWidgetSizeUpdated();
+        return;
+    }
+
     int caption_width = _caption_label->width();
     caption_width += _caption_logo_left->width() + _caption_logo_right->width();
     int line_edit_width =  caption_width;
@@ -309,62 +395,19 @@ std::shared_ptr<QtNodes::NodeData> BehaviorTreeDataModel::outData(QtNodes::PortI
     return nullptr;
 }
 
-void BehaviorTreeDataModel::readStyle()
+void BehaviorTreeDataModel::onStyleChanged()
 {
-    QFile style_file(":/NodesStyle.json");
-
-    if (!style_file.open(QIODevice::ReadOnly))
-    {
-        qWarning("Couldn't open NodesStyle.json");
-        return;
-    }
-
-    QByteArray bytearray =  style_file.readAll();
-    style_file.close();
-    QJsonParseError error;
-    QJsonDocument json_doc( QJsonDocument::fromJson( bytearray, &error ));
-
-    if(json_doc.isNull()){
-        qDebug()<<"Failed to create JSON doc: " << error.errorString();
-        return;
-    }
-    if(!json_doc.isObject()){
-        qDebug()<<"JSON is not an object.";
-        return;
-    }
-
-    QJsonObject toplevel_object = json_doc.object();
-
-    if(toplevel_object.isEmpty()){
-        qDebug()<<"JSON object is empty.";
-        return;
-    }
-    QString model_type_name( QString::fromStdString(toStr(_model.type)) );
-
-    for (const auto& model_name: { model_type_name, _model.registration_ID} )
+    _style = NodesStyle::instance().style( _model->type, _model->registration_ID );
+    initWidget();
+    if( _main_widget )
     {
-        if( toplevel_object.contains(model_name) )
-        {
-            auto category_style = toplevel_object[ model_name ].toObject() ;
-            if( category_style.contains("icon"))
-            {
-                _style_icon = category_style["icon"].toString();
-            }
-            if( category_style.contains("caption_color"))
-            {
-                _style_caption_color = category_style["caption_color"].toString();
-            }
-            if( category_style.contains("caption_alias"))
-            {
-                _style_caption_alias = category_style["caption_alias"].toString();
-            }
-        }
+        _caption_logo_left->update();
     }
 }
 
 const QString& BehaviorTreeDataModel::registrationName() const
 {
-    return _model.registration_ID;
+    return _model->registration_ID;
 }
 
 const QString &BehaviorTreeDataModel::instanceName() const
@@ -374,23 +417,7 @@ const QString &BehaviorTreeDataModel::instanceName() const
 
 PortsMapping BehaviorTreeDataModel::getCurrentPortMapping() const
 {
-    PortsMapping out;
-
-    for(const auto& it: _ports_widgets)
-    {
-        const auto& label = it.first;
-        const auto& value = it.second;
-
-        if(auto linedit = dynamic_cast<QLineEdit*>( value ) )
-        {
-            out.insert( std::make_pair( label, linedit->text() ) );
-        }
-        else if( auto combo = dynamic_cast<QComboBox*>( value ) )
-        {
-            out.insert( std::make_pair( label, combo->currentText() ) );
-        }
-    }
-    return out;
+    return _port_values;
 }
 
 QJsonObject BehaviorTreeDataModel::save() const
@@ -399,14 +426,9 @@ QJsonObject BehaviorTreeDataModel::save() const
     modelJson["name"]  = registrationName();
     modelJson["alias"] = instanceName();
 
-    for (const auto& it: _ports_widgets)
+    for (const auto& it: _port_values)
     {
-        if( auto linedit = dynamic_cast<QLineEdit*>(it.second)){
-            modelJson[it.first] = linedit->text();
-        }
-        else if( auto combo = dynamic_cast<QComboBox*>(it.second)){
-            modelJson[it.first] = combo->currentText();
-        }
+        modelJson[it.first] = it.second;
     }
 
     return modelJson;
@@ -433,6 +455,11 @@ void BehaviorTreeDataModel::restore(const QJsonObject &modelJson)
 
 void BehaviorTreeDataModel::lock(bool locked)
 {
+    _locked = locked;
+    if( !_main_widget )
+    {
+        return;
+    }
     _line_edit_name->setEnabled( !locked );
 
     for(const auto& it: _ports_widgets)
@@ -452,9 +479,17 @@ void BehaviorTreeDataModel::lock(bool locked)
 
 void BehaviorTreeDataModel::setPortMapping(const QString &port_name, const QString &value)
 {
+    auto value_it = _port_values.find(port_name);
+    if( value_it == _port_values.end() )
+    {
+        qDebug() << "error, label "<< port_name << " not found in the model";
+        return;
+    }
+
     auto it = _ports_widgets.find(port_name);
-    if( it != _ports_widgets.end() )
+    if( _main_widget && it != _ports_widgets.end() )
     {
+        // _port_values is updated by the widget
         if( auto lineedit = dynamic_cast<QLineEdit*>(it->second) )
         {
             lineedit->setText(value);
@@ -470,17 +505,324 @@ void BehaviorTreeDataModel::setPortMapping(const QString &port_name, const QStri
             }
         }
     }
+    else if( value_it->second != value )
+    {
+        value_it->second = value;
+        emit portMappingChanged();
+    }
     else{
-        qDebug() << "error, label "<< port_name << " not found in the model";
+        return;
     }
+
+    if( _painted || !_main_widget )
+    {
+        updateNodeSize();
+    }
+}
+
+QWidget *BehaviorTreeDataModel::embeddedWidget()
+{
+    if( _painted )
+    {
+        return nullptr;
+    }
+    if( !_main_widget )
+    {
+        createWidgets();
+    }
+    return _main_widget;
+}
+
+void BehaviorTreeDataModel::setPainted(bool painted)
+{
+    if( _painted == painted )
+    {
+        return;
+    }
+    _painted = painted;
+    _painted_layout.valid = false;
+    emit embeddedWidgetReplaced();
+}
+
+bool BehaviorTreeDataModel::releaseWidgets()
+{
+    // the widget must not be shown by any node
+    if( !_painted || !_main_widget || _main_widget->graphicsProxyWidget() )
+    {
+        return false;
+    }
+    // the others are its children, see createWidgets()
+    delete _main_widget;
+    _params_widget = nullptr;
+    _line_edit_name = nullptr;
+    _ports_widgets.clear();
+    _form_layout = nullptr;
+    _main_layout = nullptr;
+    _caption_label = nullptr;
+    _caption_logo_left = nullptr;
+    _caption_logo_right = nullptr;
+    return true;
+}
+
+// Draws the body of the painted models, in place of their widgets
+class BehaviorTreePainterDelegate: public QtNodes::NodePainterDelegate
+{
+public:
+    void paint(QPainter* painter, const QtNodes::NodeGeometry& geom,
+               const QtNodes::NodeDataModel* model) override
+    {
+        static_cast<const BehaviorTreeDataModel*>(model)->paintBody( painter, geom.widgetPosition() );
+    }
+
+    QSize size(const QtNodes::NodeDataModel* model) const override
+    {
+        return static_cast<const BehaviorTreeDataModel*>(model)->paintedSize();
+    }
+};
+
+QtNodes::NodePainterDelegate *BehaviorTreeDataModel::painterDelegate() const
+{
+    static BehaviorTreePainterDelegate delegate;
+    return _painted ? &delegate : nullptr;
+}
+
+static const int CAPTION_HEIGHT = 20;
+static const int ICON_WIDTH = 20;
+static const int ROW_SPACING = 2;
+static const int FORM_SPACING = 4;
+
+static QFont CaptionFont()
+{
+    QFont font;
+    font.setPointSize(12);
+    return font;
+}
+
+const BehaviorTreeDataModel::PaintedLayout &BehaviorTreeDataModel::paintedLayout() const
+{
+    auto& layout = _painted_layout;
+    if( layout.valid )
+    {
+        return layout;
+    }
+    const QFont caption_font = CaptionFont();
+    const QFontMetrics caption_metrics( caption_font );
+    const QFontMetrics metrics( (QFont()) );
+
+    auto prepared = [](const QString& text, const QFont& font)
+    {
+        QStaticText static_text( text );
+        static_text.setTextFormat( Qt::PlainText );
+        static_text.prepare( QTransform(), font );
+        return static_text;
+    };
+
+    layout.caption = prepared( _style->caption_alias, caption_font );
+    int caption_width = caption_metrics.boundingRect( _style->caption_alias ).width();
+    if( _style->icon_renderer )
+    {
+        caption_width += ICON_WIDTH + 1;
+    }
+    int line_width = caption_width;
+
+    layout.name = QStaticText();
+    if( showsInstanceName() )
+    {
+        layout.name = prepared( _instance_name, QFont() );
+        line_width = std::max( line_width, metrics.boundingRect(_instance_name).width() + MARGIN );
+    }
+
+    layout.rows.clear();
+    layout.label_width = 0;
+    layout.field_width = DEFAULT_LABEL_WIDTH;
+
+    for(const auto& port_name: orderedPorts() )
+    {
+        QString label = port_name;
+        const auto direction = _model->ports.at( port_name ).direction;
+        if( direction == PortDirection::INPUT )
+        {
+            label.prepend("[IN] ");
+        }
+        else if( direction == PortDirection::OUTPUT )
+        {
+            label.prepend("[OUT] ");
+        }
+        const QString& value = _port_values.at( port_name );
+
+        layout.label_width = std::max( layout.label_width, metrics.boundingRect(label).width() );
+        layout.field_width = std::max( layout.field_width, metrics.boundingRect(value).width() + MARGIN );
+
+        layout.rows.push_back( { prepared( label, QFont() ),
+                                 prepared( value, QFont() ),
+                                 !_highlighted_value.isEmpty() && value == _highlighted_value } );
+    }
+    layout.field_width = std::max( layout.field_width,
+                                   line_width - layout.label_width - FORM_SPACING );
+    if( !layout.rows.empty() )
+    {
+        line_width = std::max( line_width, layout.label_width + FORM_SPACING + layout.field_width );
+    }
+
+    layout.row_height = metrics.height() + 4;
+
+    int height = CAPTION_HEIGHT;
+    if( showsInstanceName() )
+    {
+        height += ROW_SPACING + layout.row_height;
+    }
+    height += int(layout.rows.size()) * (ROW_SPACING + layout.row_height);
+
+    layout.size = QSize( line_width, height );
+    layout.valid = true;
+    return layout;
+}
+
+QSize BehaviorTreeDataModel::paintedSize() const
+{
+    return paintedLayout().size;
+}
+
+void BehaviorTreeDataModel::paintBody(QPainter *painter, const QPointF &origin) const
+{
+    const auto& layout = paintedLayout();
+    const int width = layout.size.width();
+
+    painter->save();
+    painter->translate( origin );
+
+    // caption: icon and alias, centered
+    const QFont caption_font = CaptionFont();
+    const qreal caption_width = layout.caption.size().width();
+    const int icon_width = _style->icon_renderer ? ICON_WIDTH + 1 : 0;
+    qreal x = ( width - icon_width - caption_width ) / 2.0;
+
+    if( _style->icon_renderer )
+    {
+        const qreal scale = std::sqrt( std::abs( painter->deviceTransform().determinant() ) );
+        const QPixmap icon = NodesStyle::instance().iconPixmap(
+                    *_style, QSize(ICON_WIDTH, CAPTION_HEIGHT), scale );
+        painter->drawPixmap( QRectF(x, 0, ICON_WIDTH, CAPTION_HEIGHT), icon, icon.rect() );
+        x += icon_width;
+    }
+    painter->setFont( caption_font );
+    painter->setPen( _style->caption_color );
+    painter->drawStaticText( QPointF(x, (CAPTION_HEIGHT - layout.caption.size().height()) / 2.0),
+                             layout.caption );
+
+    painter->setFont( QFont() );
+    const qreal text_offset = ( layout.row_height - layout.name.size().height() ) / 2.0;
+    qreal y = CAPTION_HEIGHT;
+
+    if( showsInstanceName() )
+    {
+        y += ROW_SPACING;
+        painter->setPen( Qt::white );
+        painter->drawStaticText( QPointF( (width - layout.name.size().width()) / 2.0, y + text_offset ),
+                                 layout.name );
+        y += layout.row_height;
+    }
+
+    const qreal field_x = width - layout.field_width;
+    for(const auto& row: layout.rows)
+    {
+        y += ROW_SPACING;
+        const qreal row_offset = ( layout.row_height - row.label.size().height() ) / 2.0;
+
+        painter->setPen( Qt::white );
+        painter->drawStaticText( QPointF(0, y + row_offset), row.label );
+
+        painter->setPen( Qt::NoPen );
+        painter->setBrush( row.highlighted ? QColor("#ffef0b") : QColor(200,200,200) );
+        painter->drawRect( QRectF(field_x, y, layout.field_width, layout.row_height) );
+
+        painter->setPen( QColor(30,30,30) );
+        painter->drawStaticText( QPointF( field_x + (layout.field_width - row.value.size().width()) / 2.0,
+                                          y + row_offset ),
+                                 row.value );
+        y += layout.row_height;
+    }
+    painter->restore();
+}
+
+QLineEdit *BehaviorTreeDataModel::createFieldEditor(const QPointF &pos, QRectF *field_rect)
+{
+    if( !_painted || _locked || !paintedEditable() )
+    {
+        return nullptr;
+    }
+    const auto& layout = paintedLayout();
+    const int width = layout.size.width();
+    qreal y = CAPTION_HEIGHT;
+
+    if( showsInstanceName() )
+    {
+        y += ROW_SPACING;
+        const QRectF rect( 0, y, width, layout.row_height );
+        if( rect.contains( pos ) )
+        {
+            *field_rect = rect;
+            auto editor = new GrootLineEdit();
+            editor->setAlignment( Qt::AlignCenter );
+            editor->setText( _instance_name );
+            editor->setStyleSheet("color: white; "
+                                  "background-color: rgb(60,60,60);"
+                                  "border: 0px;");
+            connect( editor, &QLineEdit::editingFinished,
+                     this, [this, editor]()
+            {
+                if( editor->text() != _instance_name )
+                {
+                    setInstanceName( editor->text() );
+                }
+            });
+            editor->setFixedSize( rect.size().toSize() );
+            return editor;
+        }
+        y += layout.row_height;
+    }
+
+    const qreal field_x = width - layout.field_width;
+    for(const auto& port_name: orderedPorts() )
+    {
+        y += ROW_SPACING;
+        const QRectF rect( field_x, y, layout.field_width, layout.row_height );
+        if( rect.contains( pos ) )
+        {
+            *field_rect = rect;
+            auto editor = new GrootLineEdit();
+            editor->setAlignment( Qt::AlignHCenter );
+            editor->setText( _port_values.at(port_name) );
+            editor->setStyleSheet("color: rgb(30,30,30); "
+                                  "background-color: rgb(200,200,200); "
+                                  "border: 0px; ");
+            connect( editor, &QLineEdit::editingFinished,
+                     this, [this, editor, port_name]()
+            {
+                if( editor->text() != _port_values.at(port_name) )
+                {
+                    setPortMapping( port_name, editor->text() );
+                    emit parameterUpdated( port_name, editor );
+                }
+            });
+            editor->setFixedSize( rect.size().toSize() );
+            return editor;
+        }
+        y += layout.row_height;
+    }
+    return nullptr;
 }
 
 bool BehaviorTreeDataModel::eventFilter(QObject *obj, QEvent *event)
 {
-    if (event->type() == QEvent::Paint && obj == _caption_logo_left && _icon_renderer)
+    if (event->type() == QEvent::Paint && obj == _caption_logo_left && _style->icon_renderer)
     {
         QPainter paint(_caption_logo_left);
-        _icon_renderer->render(&paint);
+        const qreal scale = std::sqrt( std::abs( paint.deviceTransform().determinant() ) );
+        const QPixmap icon = NodesStyle::instance().iconPixmap(
+                    *_style, _caption_logo_left->size(),
+                    scale * _caption_logo_left->devicePixelRatioF() );
+        paint.drawPixmap( _caption_logo_left->rect(), icon );
     }
     return NodeDataModel::eventFilter(obj, event);
 }
@@ -489,7 +831,10 @@ bool BehaviorTreeDataModel::eventFilter(QObject *obj, QEvent *event)
 void BehaviorTreeDataModel::setInstanceName(const QString &name)
 {
     _instance_name = name;
-    _line_edit_name->setText( name );
+    if( _main_widget )
+    {
+        _line_edit_name->setText( name );
+    }
 
     updateNodeSize();
     emit instanceNameChanged();
@@ -498,6 +843,16 @@ void BehaviorTreeDataModel::setInstanceName(const QString &name)
 
 void BehaviorTreeDataModel::onHighlightPortValue(QString value)
 {
+    if( _painted && _highlighted_value != value )
+    {
+        _highlighted_value = value;
+        updateNodeSize();
+    }
+    _highlighted_value = value;
+    if( !_main_widget )
+    {
+        return;
+    }
     for( const auto& it:  _ports_widgets)
     {
         if( auto line_edit = dynamic_cast<QLineEdit*>(it.second) )
@@ -12,7 +12,9 @@
 #include <vector>
 #include <map>
 #include <functional>
-#include <QSvgRenderer>
+#include "NodesStyle.hpp"
+#include <QPointer>
+#include <QStaticText>
 #include "bt_editor/bt_editor_base.h"
 #include "bt_editor/utils.h"
 
@@ -27,10 +29,17 @@ class BehaviorTreeDataModel : public NodeDataModel
     Q_OBJECT
 
 public:
-    BehaviorTreeDataModel(const NodeModel &model );
+    BehaviorTreeDataModel(const NodeModelPtr &model );
 
     ~BehaviorTreeDataModel() override;
 
+    // Mode of the models created from now on. Painted models have no
+    // widgets: caption, name and ports are drawn by the NodePainter,
+    // that is enough for a tree that can't be edited (monitor and replay).
+    static void setPaintedByDefault(bool painted);
+
+    static bool paintedByDefault();
+
 public:
 
     NodeType nodeType() const;
@@ -53,7 +62,10 @@ public:
 
     const QString &registrationName() const;
 
-    const NodeModel &model() const { return _model; }
+    const NodeModel &model() const { return *_model; }
+
+    // shared by all the nodes created from the same registration
+    const NodeModelPtr &modelPtr() const { return _model; }
 
     QString name() const final { return registrationName(); }
 
@@ -61,22 +73,56 @@ public:
 
     PortsMapping getCurrentPortMapping() const;
 
-    QWidget *embeddedWidget() final { return _main_widget; }
+    // Null if painted. Otherwise, the widgets are created on demand.
+    QWidget *embeddedWidget() final;
 
     QWidget *parametersWidget() { return _params_widget; }
 
+    QtNodes::NodePainterDelegate* painterDelegate() const override;
+
+    // The widgets are kept, if they exist already, but not shown
+    void setPainted(bool painted);
+
+    bool painted() const { return _painted; }
+
+    // Destroy the widgets of a painted model, they are created again when
+    // it stops being painted. Return false if the widgets are kept.
+    virtual bool releaseWidgets();
+
+    // Area drawn in place of the widgets
+    QSize paintedSize() const;
+
+    void paintBody(QPainter* painter, const QPointF& origin) const;
+
+    // The fields of the painted body are edited without widgets, one at
+    // a time, by createFieldEditor()
+    virtual bool paintedEditable() const { return true; }
+
+    // Line edit for the field of the painted body at pos, relative to the
+    // body, or nullptr if there is none. field_rect is set to the area of
+    // the field. The model is updated when the editing is finished.
+    QLineEdit* createFieldEditor(const QPointF& pos, QRectF* field_rect);
+
     QJsonObject save() const override;
 
     void restore(QJsonObject const &) override;
 
     void lock(bool locked);
 
+    // Kept for the graphics object of the node, which might be created
+    // later, see GraphicContainer::lockNodeGraphics()
+    bool locked() const { return _locked; }
+
     void setPortMapping(const QString& port_name, const QString& value);
 
     int UID() const { return _uid; }
 
     bool eventFilter(QObject *obj, QEvent *event) override;
 
+    bool resetToDefault() override;
+
+    void prepareForReuse() override;
+
 
 public slots:
 
@@ -84,9 +130,20 @@ public slots:
 
     void onHighlightPortValue(QString value);
 
+    // NodesStyle was reloaded
+    void onStyleChanged();
+
 protected:
 
-    QFrame*  _main_widget;
+    // Build the widgets, from the current state of the model
+    virtual void createWidgets();
+
+    // Show the instance name below the caption
+    virtual bool showsInstanceName() const { return true; }
+
+    // owned by the node showing it, if any. The other widgets are its
+    // children and they exist only if _main_widget is not null
+    QPointer<QFrame> _main_widget;
     QFrame*  _params_widget;
 
     QLineEdit* _line_edit_name;
@@ -101,14 +158,39 @@ protected:
     QFrame* _caption_logo_right;
 
 private:
-    const NodeModel _model;
-    QString _instance_name;
-    QSvgRenderer* _icon_renderer;
 
-    void readStyle();
-    QString _style_icon;
-    QColor  _style_caption_color;
-    QString  _style_caption_alias;
+    struct PaintedRow
+    {
+        QStaticText label;
+        QStaticText value;
+        bool highlighted;
+    };
+
+    struct PaintedLayout
+    {
+        bool valid = false;
+        QStaticText caption;
+        QStaticText name;
+        std::vector<PaintedRow> rows;
+        int label_width = 0;
+        int field_width = 0;
+        int row_height = 0;
+        QSize size;
+    };
+
+    // Ports in the order they are shown: inputs, outputs, then the others
+    std::vector<QString> orderedPorts() const;
+
+    const PaintedLayout& paintedLayout() const;
+
+    const NodeModelPtr _model;
+    QString _instance_name;
+    PortsMapping _port_values;
+    QString _highlighted_value;
+    bool _locked;
+    bool _painted;
+    mutable PaintedLayout _painted_layout;
+    NodesStyle::EntryPtr _style;
 
 signals:
 
@@ -116,10 +198,36 @@ signals:
 
     void instanceNameChanged();
 
+    // The value of a port changed, including while it is being edited
+    void portMappingChanged();
+
     void portValueDoubleChicked(QLineEdit* value_port);
 
 };
 
+// Change the mode of the models created in its lifetime, restoring the
+// previous one on destruction, also when the creation throws.
+class PaintedByDefaultScope
+{
+public:
+    explicit PaintedByDefaultScope(bool painted):
+        _previous( BehaviorTreeDataModel::paintedByDefault() )
+    {
+        BehaviorTreeDataModel::setPaintedByDefault( painted );
+    }
+
+    ~PaintedByDefaultScope()
+    {
+        BehaviorTreeDataModel::setPaintedByDefault( _previous );
+    }
+
+    PaintedByDefaultScope(const PaintedByDefaultScope&) = delete;
+    PaintedByDefaultScope& operator=(const PaintedByDefaultScope&) = delete;
+
+private:
+    bool _previous;
+};
+
 
 class GrootLineEdit: public QLineEdit
 {
@@ -0,0 +1,185 @@
+#include "NodesStyle.hpp"
+#include <QFile>
+#include <QDebug>
+#include <QPainter>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QtMath>
+#include <QApplication>
+#include <cmath>
+#include <nodes/NodeStyle>
+
+static const char* BUILTIN_STYLE_FILE = ":/NodesStyle.json";
+
+NodesStyle &NodesStyle::instance()
+{
+    // destroyed with the application, together with its pixmaps
+    static NodesStyle* nodes_style = new NodesStyle( qApp );
+    return *nodes_style;
+}
+
+NodesStyle::NodesStyle(QObject *parent):
+    QObject( parent ),
+    _style_file( BUILTIN_STYLE_FILE ),
+    _default_caption_color( QtNodes::NodeStyle().FontColor )
+{
+    connect( &_watcher, &QFileSystemWatcher::fileChanged,
+             this, [this](const QString& path)
+    {
+        // editors often replace the file, instead of writing it
+        if( !_watcher.files().contains(path) && QFileInfo::exists(path) )
+        {
+            _watcher.addPath(path);
+        }
+        reload();
+    });
+    reload();
+}
+
+void NodesStyle::setStyleFile(const QString &path)
+{
+    if( !_watcher.files().isEmpty() )
+    {
+        _watcher.removePaths( _watcher.files() );
+    }
+    _style_file = path.isEmpty() ? QString(BUILTIN_STYLE_FILE) : path;
+
+    if( !_style_file.startsWith(":") )
+    {
+        _watcher.addPath( _style_file );
+    }
+    reload();
+}
+
+void NodesStyle::reload()
+{
+    _styles = QJsonObject();
+    _entries.clear();
+    _renderers.clear();
+    _pixmaps.clear();
+
+    QFile style_file( _style_file );
+    if (!style_file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Couldn't open" << _style_file;
+    }
+    else
+    {
+        QByteArray bytearray =  style_file.readAll();
+        style_file.close();
+        QJsonParseError error;
+        QJsonDocument json_doc( QJsonDocument::fromJson( bytearray, &error ));
+
+        if(json_doc.isNull()){
+            qDebug()<<"Failed to create JSON doc: " << error.errorString();
+        }
+        else if(!json_doc.isObject()){
+            qDebug()<<"JSON is not an object.";
+        }
+        else{
+            _styles = json_doc.object();
+        }
+    }
+    emit styleChanged();
+}
+
+NodesStyle::EntryPtr NodesStyle::style(NodeType type, const QString &registration_ID)
+{
+    const auto key = std::make_pair( type, registration_ID );
+    auto it = _entries.find( key );
+    if( it != _entries.end() )
+    {
+        return it->second;
+    }
+
+    auto entry = std::make_shared<Entry>();
+    entry->caption_color = _default_caption_color;
+    entry->caption_alias = registration_ID;
+
+    QString model_type_name( QString::fromStdString(toStr(type)) );
+
+    for (const auto& model_name: { model_type_name, registration_ID} )
+    {
+        if( _styles.contains(model_name) )
+        {
+            auto category_style = _styles[ model_name ].toObject() ;
+            if( category_style.contains("icon"))
+            {
+                entry->icon = category_style["icon"].toString();
+            }
+            if( category_style.contains("caption_color"))
+            {
+                entry->caption_color = category_style["caption_color"].toString();
+            }
+            if( category_style.contains("caption_alias"))
+            {
+                entry->caption_alias = category_style["caption_alias"].toString();
+            }
+        }
+    }
+    entry->icon_renderer = iconRenderer( entry->icon, entry->caption_color );
+
+    _entries.insert( {key, entry} );
+    return entry;
+}
+
+std::shared_ptr<QSvgRenderer> NodesStyle::iconRenderer(const QString &icon,
+                                                       const QColor &color)
+{
+    if( icon.isEmpty() )
+    {
+        return nullptr;
+    }
+    const auto key = std::make_pair( icon, color.rgba() );
+    auto it = _renderers.find( key );
+    if( it != _renderers.end() )
+    {
+        return it->second;
+    }
+
+    std::shared_ptr<QSvgRenderer> renderer;
+    QFile file(icon);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        qDebug()<<"file not opened: "<< icon;
+    }
+    else {
+        QByteArray ba = file.readAll();
+        QByteArray new_color_fill = QString("fill:%1;").arg( color.name() ).toUtf8();
+        ba.replace("fill:#ffffff;", new_color_fill);
+        renderer = std::make_shared<QSvgRenderer>(ba);
+    }
+    // a missing file is not searched again
+    _renderers.insert( {key, renderer} );
+    return renderer;
+}
+
+QPixmap NodesStyle::iconPixmap(const Entry &style, const QSize &size, qreal scale)
+{
+    if( !style.icon_renderer || size.isEmpty() )
+    {
+        return QPixmap();
+    }
+    // from 1/4 to 16 times the logical size, in powers of two
+    const int bucket = qBound( 0, qCeil( std::log2( std::max(scale, 0.01) ) ) + 2, 6 );
+    const auto key = std::make_tuple( style.icon_renderer.get(),
+                                      size.width(), size.height(), bucket );
+    auto it = _pixmaps.find( key );
+    if( it != _pixmaps.end() )
+    {
+        return it->second;
+    }
+
+    const qreal ratio = std::pow( 2.0, bucket - 2 );
+    QPixmap pixmap( size * ratio );
+    pixmap.fill( Qt::transparent );
+    {
+        QPainter painter( &pixmap );
+        painter.setRenderHint( QPainter::Antialiasing );
+        style.icon_renderer->render( &painter );
+    }
+    pixmap.setDevicePixelRatio( ratio );
+
+    _pixmaps.insert( {key, pixmap} );
+    return pixmap;
+}
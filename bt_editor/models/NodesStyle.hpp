@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QObject>
+#include <QColor>
+#include <QString>
+#include <QPixmap>
+#include <QJsonObject>
+#include <QSvgRenderer>
+#include <QFileSystemWatcher>
+#include <map>
+#include <tuple>
+#include <memory>
+#include "bt_editor/bt_editor_base.h"
+
+/// Caption style of the nodes, as defined in NodesStyle.json.
+///
+/// The file is parsed once per process and the style of each model is
+/// resolved the first time it is requested; the icons are shared by all the
+/// models with the same (icon, color) pair and rasterized once per zoom level.
+/// Only to be used from the GUI thread.
+class NodesStyle : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    struct Entry
+    {
+        QString icon;
+        QColor caption_color;
+        QString caption_alias;
+        // null if there is no icon, or it couldn't be loaded
+        std::shared_ptr<QSvgRenderer> icon_renderer;
+    };
+
+    typedef std::shared_ptr<const Entry> EntryPtr;
+
+    static NodesStyle& instance();
+
+    // The entries of the type are overridden by the ones of the registration_ID
+    EntryPtr style(NodeType type, const QString& registration_ID);
+
+    // The icon of the style, rasterized for the given logical size and
+    // scale (zoom of the view times the device pixel ratio).
+    // Null if the style has no icon.
+    QPixmap iconPixmap(const Entry& style, const QSize& size, qreal scale);
+
+    // A file on disk is watched and read again whenever it changes.
+    // An empty path restores the builtin style, ":/NodesStyle.json".
+    void setStyleFile(const QString& path);
+
+    const QString& styleFile() const { return _style_file; }
+
+    // Parse the style file again and forget the cached entries
+    void reload();
+
+signals:
+
+    // The entries returned so far are obsolete
+    void styleChanged();
+
+private:
+
+    NodesStyle(QObject* parent);
+
+    std::shared_ptr<QSvgRenderer> iconRenderer(const QString& icon, const QColor& color);
+
+    QString _style_file;
+    QJsonObject _styles;
+    QColor _default_caption_color;
+    QFileSystemWatcher _watcher;
+
+    std::map<std::pair<NodeType, QString>, EntryPtr> _entries;
+    std::map<std::pair<QString, QRgb>, std::shared_ptr<QSvgRenderer>> _renderers;
+    // (renderer, width, height, zoom bucket)
+    std::map<std::tuple<const QSvgRenderer*, int, int, int>, QPixmap> _pixmaps;
+};
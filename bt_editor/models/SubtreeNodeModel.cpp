@@ -3,12 +3,18 @@
 #include <QLineEdit>
 #include <QVBoxLayout>
 
-SubtreeNodeModel::SubtreeNodeModel(const NodeModel &model):
+SubtreeNodeModel::SubtreeNodeModel(const NodeModelPtr &model):
     BehaviorTreeDataModel ( model ),
+    _expand_button(nullptr),
     _expanded(false)
 {
+}
+
+void SubtreeNodeModel::createWidgets()
+{
+    BehaviorTreeDataModel::createWidgets();
+
     _line_edit_name->setReadOnly(true);
-    _line_edit_name->setHidden(true);
 
     _expand_button = new QPushButton( _expanded ? "Collapse" : "Expand", _main_widget );
     _expand_button->setMaximumWidth(100);
@@ -34,17 +40,48 @@ SubtreeNodeModel::SubtreeNodeModel(const NodeModel &model):
     updateNodeSize();
 }
 
+QPushButton *SubtreeNodeModel::expandButton()
+{
+    if( !_main_widget )
+    {
+        createWidgets();
+    }
+    return _expand_button;
+}
+
 void SubtreeNodeModel::setExpanded(bool expand)
 {
     _expanded = expand;
-    _expand_button->setText( _expanded ? "Collapse" : "Expand");
-    _expand_button->adjustSize();
-    _main_widget->adjustSize();
+    if( _main_widget )
+    {
+        _expand_button->setText( _expanded ? "Collapse" : "Expand");
+        _expand_button->adjustSize();
+        _main_widget->adjustSize();
+    }
+}
+
+bool SubtreeNodeModel::resetToDefault()
+{
+    if( !BehaviorTreeDataModel::resetToDefault() )
+    {
+        return false;
+    }
+    setExpanded( false );
+    if( _main_widget )
+    {
+        _expand_button->setEnabled( true );
+        _expand_button->setHidden( false );
+        _line_edit_name->setHidden( true );
+    }
+    return true;
 }
 
 void SubtreeNodeModel::setInstanceName(const QString &name)
 {
-    _line_edit_name->setHidden( name == registrationName() );
+    if( _main_widget )
+    {
+        _line_edit_name->setHidden( name == registrationName() );
+    }
     BehaviorTreeDataModel::setInstanceName(name);
 }
 
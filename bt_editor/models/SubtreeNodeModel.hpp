@@ -9,7 +9,7 @@ class SubtreeNodeModel : public BehaviorTreeDataModel
     Q_OBJECT
 public:
 
-    SubtreeNodeModel(const NodeModel& model);
+    SubtreeNodeModel(const NodeModelPtr& model);
 
     ~SubtreeNodeModel() override = default;
 
@@ -27,10 +27,19 @@ public:
 
     static const char* Name() { return "SubTree";  }
 
-    QPushButton* expandButton() { return _expand_button; }
+    // The widgets are created, if they don't exist yet
+    QPushButton* expandButton();
 
     virtual void setInstanceName(const QString& name) override;
 
+    bool resetToDefault() override;
+
+    // Kept: the state of the expand button is set by the GraphicContainer
+    bool releaseWidgets() override { return false; }
+
+    // the expand button is a widget
+    bool paintedEditable() const override { return false; }
+
     QJsonObject save() const override;
 
     void restore(QJsonObject const &) override;
@@ -38,6 +47,15 @@ public:
 signals:
     void expandButtonPushed();
 
+protected:
+
+    void createWidgets() override;
+
+    bool showsInstanceName() const override
+    {
+        return !instanceName().isEmpty() && instanceName() != registrationName();
+    }
+
 private:
     QPushButton* _expand_button;
     bool _expanded;
@@ -0,0 +1,142 @@
+#include "replay_exporter.h"
+
+#include <QPainter>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
+#include <nodes/Node>
+#include <nodes/Connection>
+#include <nodes/FlowViewStyle>
+#include "utils.h"
+#include "graphic_container.h"
+
+using QtNodes::PortType;
+
+ReplayExporter::ReplayExporter(GraphicContainer *container, qreal scale):
+    _container(container),
+    _scene(container->scene()),
+    _prev_detail_level(_scene->detailLevel()),
+    _tree(container->loadedTree()),
+    _scale(scale),
+    _first_frame(true),
+    _write_failed(false)
+{
+    _scene->setDetailLevel( QtNodes::DetailLevel::Full );
+
+    const qreal MARGIN = 20;
+    _scene_rect = _scene->nodesBoundingRect().adjusted(-MARGIN, -MARGIN, MARGIN, MARGIN);
+
+    const QSize image_size = (_scene_rect.size() * _scale).toSize();
+    _frame = QImage( image_size, QImage::Format_ARGB32_Premultiplied );
+
+    // limit the memory used by the frames waiting to be written
+    _max_pending_writes = std::max( 2, QThread::idealThreadCount() * 2 );
+
+    _current_status.resize( _tree.nodesCount(), { NodeStatus::IDLE, NodeStatus::IDLE } );
+}
+
+ReplayExporter::~ReplayExporter()
+{
+    finish();
+    _scene->setDetailLevel( _prev_detail_level );
+}
+
+void ReplayExporter::updateDirtyArea(QtNodes::Node* node)
+{
+    // some extra room for the pen and the shadow
+    const qreal BORDER = 10;
+    // the nodes of a large tree might have no graphics object
+    QRectF area = node->nodeGeometry().boundingRect()
+                      .translated( _scene->getNodePosition( *node ) );
+
+    const auto& conn_in = node->nodeState().connections(PortType::In, 0 );
+    if( conn_in.size() == 1 )
+    {
+        // without a graphics object, its geometry is in scene coordinates
+        const QtNodes::Connection* conn = conn_in.begin()->second;
+        area |= conn->hasGraphicsObject() ?
+                    conn->connectionGraphicsObject().sceneBoundingRect() :
+                    conn->connectionGeometry().boundingRect();
+    }
+    _dirty_area |= area.adjusted(-BORDER, -BORDER, BORDER, BORDER);
+}
+
+void ReplayExporter::setNodesStatus(const std::vector<std::pair<NodeStatus, NodeStatus>> &nodes_status)
+{
+    const size_t count = std::min( nodes_status.size(), _tree.nodesCount() );
+
+    for (size_t index = 0; index < count; index++)
+    {
+        if( !_first_frame && nodes_status[index] == _current_status[index] )
+        {
+            continue;
+        }
+        _current_status[index] = nodes_status[index];
+
+        auto gui_node = _tree.node(index)->graphic_node;
+        if( !gui_node )
+        {
+            continue;
+        }
+        auto style = getStyleFromStatus( nodes_status[index].first, nodes_status[index].second );
+        _container->applyNodeStyle( *gui_node, style.first, style.second );
+        updateDirtyArea( gui_node );
+    }
+}
+
+void ReplayExporter::saveFrame(const QString &filename)
+{
+    const QColor background = QtNodes::FlowViewStyle().BackgroundColor;
+
+    // the restyled items are marked for repaint, i.e. for render() too
+    _container->flushStyleUpdates();
+
+    QPainter painter( &_frame );
+    painter.setRenderHint( QPainter::Antialiasing );
+
+    if( _first_frame )
+    {
+        _frame.fill( background );
+        _scene->render( &painter, QRectF(_frame.rect()), _scene_rect, Qt::IgnoreAspectRatio );
+        _first_frame = false;
+    }
+    else if( !_dirty_area.isEmpty() )
+    {
+        // align the dirty area to whole pixels of the image
+        const QRectF dirty_image = QRectF( (_dirty_area.topLeft() - _scene_rect.topLeft()) * _scale,
+                                           _dirty_area.size() * _scale );
+        const QRect target = dirty_image.toAlignedRect().intersected( _frame.rect() );
+
+        const QRectF source( _scene_rect.topLeft() + QPointF(target.topLeft()) / _scale,
+                             QSizeF(target.size()) / _scale );
+
+        painter.setClipRect( target );
+        painter.fillRect( target, background );
+        _scene->render( &painter, QRectF(target), source, Qt::IgnoreAspectRatio );
+    }
+    painter.end();
+    _dirty_area = QRectF();
+
+    while( _pending_writes.size() >= _max_pending_writes )
+    {
+        _write_failed |= !_pending_writes.front().result();
+        _pending_writes.pop_front();
+    }
+
+    // implicitly shared: the worker gets its own copy as soon as this
+    // frame is modified by the next call.
+    const QImage frame = _frame;
+    _pending_writes.push_back( QtConcurrent::run( [frame, filename]()
+    {
+        return frame.save( filename, "PNG" );
+    }));
+}
+
+bool ReplayExporter::finish()
+{
+    while( !_pending_writes.empty() )
+    {
+        _write_failed |= !_pending_writes.front().result();
+        _pending_writes.pop_front();
+    }
+    return !_write_failed;
+}
@@ -0,0 +1,60 @@
+#ifndef REPLAY_EXPORTER_H
+#define REPLAY_EXPORTER_H
+
+#include <deque>
+#include <QImage>
+#include <QFuture>
+#include <nodes/FlowScene>
+#include "bt_editor_base.h"
+
+class GraphicContainer;
+
+/// Renders the frames of a replay into PNG images, without any view.
+///
+/// Each frame is painted on top of the previous one, re-rendering only the
+/// area of the nodes whose status changed. The PNG encoding, which is by far
+/// the most expensive step, runs on a pool of worker threads, each of them
+/// with its own copy of the frame.
+///
+/// The scene is rendered at full detail, whatever the zoom of its view; its
+/// detail level is restored by the destructor.
+class ReplayExporter
+{
+public:
+
+    ReplayExporter(GraphicContainer* container, qreal scale = 1.0);
+
+    ~ReplayExporter();
+
+    // For each node, the pair (status, previous status), see ResolveNodesStatus().
+    // The styles are applied by the container, like the ones of the replay.
+    void setNodesStatus(const std::vector<std::pair<NodeStatus, NodeStatus>>& nodes_status);
+
+    // Render the current frame and queue it to be written to file
+    void saveFrame(const QString& filename);
+
+    // Wait until all the frames are written. Return false if any of them failed
+    bool finish();
+
+private:
+
+    void updateDirtyArea(QtNodes::Node* node);
+
+    GraphicContainer* _container;
+    QtNodes::FlowScene* _scene;
+    QtNodes::DetailLevel _prev_detail_level;
+    AbsBehaviorTree _tree;
+    QRectF _scene_rect;
+    qreal _scale;
+
+    QImage _frame;
+    bool _first_frame;
+    QRectF _dirty_area;
+    std::vector<std::pair<NodeStatus, NodeStatus>> _current_status;
+
+    std::deque<QFuture<bool>> _pending_writes;
+    size_t _max_pending_writes;
+    bool _write_failed;
+};
+
+#endif // REPLAY_EXPORTER_H
@@ -0,0 +1,270 @@
+#include "replay_flamegraph_widget.h"
+
+#include <QPainter>
+#include <QLabel>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QHelpEvent>
+#include <QToolTip>
+#include <functional>
+
+class FlameGraphCanvas : public QWidget
+{
+public:
+    FlameGraphCanvas(ReplayFlameGraphWidget* parent):
+        QWidget(parent), _graph(parent)
+    {
+        setMinimumHeight( 100 );
+    }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+    bool event(QEvent *event) override;
+
+private:
+    ReplayFlameGraphWidget* _graph;
+
+    // rectangles drawn during the last paintEvent
+    std::vector< std::pair<QRectF,int> > _boxes;
+};
+
+namespace
+{
+const double ROW_HEIGHT = 20;
+}
+
+void FlameGraphCanvas::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect( rect(), palette().base() );
+    _boxes.clear();
+
+    const auto tree = _graph->tree();
+    const auto& entries = _graph->entries();
+
+    if( !tree || entries.empty() || entries[0].subtree_time <= 0 )
+    {
+        painter.setPen( palette().text().color() );
+        painter.drawText( rect(), Qt::AlignCenter, "No RUNNING node in the selected range" );
+        return;
+    }
+
+    const double scale = width() / entries[0].subtree_time;
+
+    std::function<void(int,double,int)> recursiveStep;
+    recursiveStep = [&](int index, double x, int depth)
+    {
+        const double box_width = entries[index].subtree_time * scale;
+        const double y = depth * ROW_HEIGHT;
+        if( box_width < 1.0 || y > height() )
+        {
+            return;
+        }
+        const QRectF box( x, y, box_width, ROW_HEIGHT - 1 );
+        const auto node = tree->node(index);
+
+        // warm colors, stable for a given name
+        const uint hash = qHash( node->instance_name );
+        const QColor color = QColor::fromHsv( 10 + hash % 40, 150 + hash % 80, 230 );
+
+        painter.fillRect( box, color );
+        _boxes.push_back( { box, index } );
+
+        if( box_width > 30 )
+        {
+            const QString label = painter.fontMetrics().elidedText(
+                        (index == 0) ? QString("Total") : node->instance_name,
+                        Qt::ElideRight, int(box_width) - 6 );
+            painter.setPen( Qt::black );
+            painter.drawText( box.adjusted(3,0,-3,0), Qt::AlignVCenter | Qt::AlignLeft, label );
+        }
+
+        double child_x = x;
+        for (int child_index: node->children_index)
+        {
+            recursiveStep( child_index, child_x, depth+1 );
+            child_x += entries[child_index].subtree_time * scale;
+        }
+    };
+    recursiveStep( 0, 0.0, 0 );
+}
+
+bool FlameGraphCanvas::event(QEvent *event)
+{
+    if( event->type() == QEvent::ToolTip )
+    {
+        auto help_event = static_cast<QHelpEvent*>(event);
+        const auto& entries = _graph->entries();
+
+        for (const auto& box: _boxes)
+        {
+            if( box.first.contains( help_event->pos() ) )
+            {
+                const int index = box.second;
+                const auto node = _graph->tree()->node(index);
+
+                double children_time = 0;
+                for (int child_index: node->children_index)
+                {
+                    children_time += entries[child_index].subtree_time;
+                }
+                const double total = entries[0].subtree_time;
+                const double self_time = std::max(0.0, entries[index].running_time - children_time);
+
+                QToolTip::showText( help_event->globalPos(),
+                                    QString("%1\nRUNNING: %2 s (%3%)\nself: %4 s")
+                                    .arg( node->instance_name )
+                                    .arg( entries[index].running_time, 0, 'f', 3 )
+                                    .arg( 100.0 * entries[index].subtree_time / total, 0, 'f', 1 )
+                                    .arg( self_time, 0, 'f', 3 ) );
+                return true;
+            }
+        }
+        QToolTip::hideText();
+        event->ignore();
+        return true;
+    }
+    return QWidget::event(event);
+}
+
+//--------------------------------------------------
+
+ReplayFlameGraphWidget::ReplayFlameGraphWidget(QWidget *parent) :
+    QWidget(parent),
+    _tree(nullptr),
+    _timeline(nullptr),
+    _current_time(0),
+    _range(0,0)
+{
+    _combo_scope = new QComboBox(this);
+    _combo_scope->addItem("Whole log");
+    _combo_scope->addItem("Current execution");
+    _combo_scope->addItem("Time range");
+
+    _spin_begin = new QDoubleSpinBox(this);
+    _spin_end   = new QDoubleSpinBox(this);
+    for (auto spin: {_spin_begin, _spin_end})
+    {
+        spin->setDecimals(3);
+        spin->setSuffix(" s");
+        spin->setEnabled(false);
+    }
+
+    _canvas = new FlameGraphCanvas(this);
+
+    auto controls = new QHBoxLayout();
+    controls->addWidget( _combo_scope );
+    controls->addWidget( new QLabel("from", this) );
+    controls->addWidget( _spin_begin );
+    controls->addWidget( new QLabel("to", this) );
+    controls->addWidget( _spin_end );
+    controls->addStretch();
+
+    auto main_layout = new QVBoxLayout(this);
+    main_layout->addLayout( controls );
+    main_layout->addWidget( _canvas, 1 );
+
+    connect( _combo_scope, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+             this, &ReplayFlameGraphWidget::updateRange );
+    connect( _spin_begin, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+             this, &ReplayFlameGraphWidget::updateRange );
+    connect( _spin_end, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+             this, &ReplayFlameGraphWidget::updateRange );
+}
+
+void ReplayFlameGraphWidget::setTimeline(const AbsBehaviorTree *tree,
+                                         const ReplayTimeline *timeline)
+{
+    _tree = tree;
+    _timeline = timeline;
+
+    const double duration = _timeline ? (_timeline->endTime() - _timeline->startTime()) : 0;
+    for (auto spin: {_spin_begin, _spin_end})
+    {
+        QSignalBlocker blocker(spin);
+        spin->setRange( 0, duration );
+    }
+    {
+        QSignalBlocker blocker(_spin_begin);
+        _spin_begin->setValue( 0 );
+    }
+    {
+        QSignalBlocker blocker(_spin_end);
+        _spin_end->setValue( duration );
+    }
+
+    // force a full computation
+    _range = { 0, -1 };
+    _entries.clear();
+    updateRange();
+}
+
+void ReplayFlameGraphWidget::setCurrentTime(double timestamp)
+{
+    _current_time = timestamp;
+    if( _combo_scope->currentIndex() == 1 )
+    {
+        updateRange();
+    }
+}
+
+void ReplayFlameGraphWidget::updateRange()
+{
+    if( !_timeline || !_tree )
+    {
+        return;
+    }
+    const double origin = _timeline->startTime();
+    std::pair<double,double> range( _timeline->startTime(), _timeline->endTime() );
+
+    const int scope = _combo_scope->currentIndex();
+    if( scope == 1 )
+    {
+        range = _timeline->executionRange( _current_time );
+    }
+    else if( scope == 2 )
+    {
+        range = { origin + _spin_begin->value(), origin + _spin_end->value() };
+    }
+    _spin_begin->setEnabled( scope == 2 );
+    _spin_end->setEnabled( scope == 2 );
+
+    // nothing to do when, for instance, the cursor moves within the same execution
+    if( range == _range && _entries.size() == _tree->nodesCount() )
+    {
+        return;
+    }
+    recompute( range.first, range.second );
+    _range = range;
+    _canvas->update();
+}
+
+void ReplayFlameGraphWidget::recompute(double t_begin, double t_end)
+{
+    const size_t nodes_count = std::min( _tree->nodesCount(), _timeline->nodesCount() );
+    _entries.assign( _tree->nodesCount(), Entry() );
+
+    for (size_t index = 0; index < nodes_count; index++)
+    {
+        _entries[index].running_time = _timeline->runningTime( index, t_begin, t_end );
+    }
+
+    // aggregate from the leaves to the root
+    std::function<double(int)> recursiveStep;
+    recursiveStep = [&](int index) -> double
+    {
+        double children_time = 0;
+        for (int child_index: _tree->node(index)->children_index)
+        {
+            children_time += recursiveStep( child_index );
+        }
+        Entry& entry = _entries[index];
+        entry.subtree_time = std::max( entry.running_time, children_time );
+        return entry.subtree_time;
+    };
+    if( !_entries.empty() )
+    {
+        recursiveStep( 0 );
+    }
+}
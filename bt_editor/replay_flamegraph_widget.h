@@ -0,0 +1,60 @@
+#ifndef REPLAY_FLAMEGRAPH_WIDGET_H
+#define REPLAY_FLAMEGRAPH_WIDGET_H
+
+#include <QWidget>
+#include <QComboBox>
+#include <QDoubleSpinBox>
+#include "bt_editor_base.h"
+#include "replay_timeline.h"
+
+class FlameGraphCanvas;
+
+/// Icicle graph of the time spent in RUNNING state by each node of the tree,
+/// where each node is drawn below its parent and as wide as its subtree.
+/// It can be computed for the whole log, for the execution under the replay
+/// cursor or for an arbitrary time range.
+class ReplayFlameGraphWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ReplayFlameGraphWidget(QWidget *parent = nullptr);
+
+    // Both tree and timeline are owned by the caller and must outlive this widget
+    void setTimeline(const AbsBehaviorTree* tree, const ReplayTimeline* timeline);
+
+    void setCurrentTime(double timestamp);
+
+    struct Entry{
+        double running_time = 0; // time spent by the node itself
+        double subtree_time = 0; // max(running_time, sum of children subtree_time)
+    };
+
+    const std::vector<Entry>& entries() const { return _entries; }
+
+    const AbsBehaviorTree* tree() const { return _tree; }
+
+    std::pair<double,double> selectedRange() const { return _range; }
+
+private slots:
+
+    void updateRange();
+
+private:
+
+    void recompute(double t_begin, double t_end);
+
+    const AbsBehaviorTree* _tree;
+    const ReplayTimeline* _timeline;
+
+    QComboBox* _combo_scope;
+    QDoubleSpinBox* _spin_begin;
+    QDoubleSpinBox* _spin_end;
+    FlameGraphCanvas* _canvas;
+
+    double _current_time;
+    std::pair<double,double> _range;
+    std::vector<Entry> _entries;
+};
+
+#endif // REPLAY_FLAMEGRAPH_WIDGET_H
@@ -0,0 +1,227 @@
+#include "replay_gantt_widget.h"
+
+#include <QPainter>
+#include <QScrollBar>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <functional>
+
+namespace
+{
+const int ROW_HEIGHT  = 18;
+const int LABEL_WIDTH = 180;
+const int INDENT_WIDTH = 10;
+const double MAX_CHART_PIXELS = 1e9;
+}
+
+ReplayGanttWidget::ReplayGanttWidget(QWidget *parent) :
+    QAbstractScrollArea(parent),
+    _tree(nullptr),
+    _timeline(nullptr),
+    _pixels_per_second(100),
+    _current_time(0)
+{
+    horizontalScrollBar()->setSingleStep( 20 );
+    verticalScrollBar()->setSingleStep( 1 );
+}
+
+void ReplayGanttWidget::setTimeline(const AbsBehaviorTree *tree,
+                                    const ReplayTimeline *timeline)
+{
+    _tree = tree;
+    _timeline = timeline;
+    _rows.clear();
+    _depth.clear();
+
+    if( _tree && _tree->nodesCount() > 0 )
+    {
+        // the first node is the synthetic "Root", skip it
+        std::function<void(int,int)> recursiveStep;
+        recursiveStep = [&](int index, int depth)
+        {
+            _rows.push_back( index );
+            _depth.push_back( depth );
+            for (int child_index: _tree->node(index)->children_index)
+            {
+                recursiveStep( child_index, depth+1 );
+            }
+        };
+        for (int child_index: _tree->node(0)->children_index)
+        {
+            recursiveStep( child_index, 0 );
+        }
+    }
+
+    const double duration = _timeline ? (_timeline->endTime() - _timeline->startTime()) : 0;
+    _pixels_per_second = (duration > 0) ? std::max(1, chartWidth()) / duration : 100;
+
+    updateScrollBars();
+    horizontalScrollBar()->setValue(0);
+    verticalScrollBar()->setValue(0);
+    viewport()->update();
+}
+
+void ReplayGanttWidget::setCurrentTime(double timestamp)
+{
+    if( _current_time != timestamp )
+    {
+        _current_time = timestamp;
+        viewport()->update();
+    }
+}
+
+int ReplayGanttWidget::chartWidth() const
+{
+    return viewport()->width() - LABEL_WIDTH;
+}
+
+double ReplayGanttWidget::timeAt(double x) const
+{
+    const double start = _timeline ? _timeline->startTime() : 0;
+    return start + (x - LABEL_WIDTH + horizontalScrollBar()->value()) / _pixels_per_second;
+}
+
+double ReplayGanttWidget::xAt(double timestamp) const
+{
+    const double start = _timeline ? _timeline->startTime() : 0;
+    return LABEL_WIDTH + (timestamp - start) * _pixels_per_second - horizontalScrollBar()->value();
+}
+
+void ReplayGanttWidget::updateScrollBars()
+{
+    const double duration = _timeline ? (_timeline->endTime() - _timeline->startTime()) : 0;
+    const double total_width = duration * _pixels_per_second;
+
+    horizontalScrollBar()->setPageStep( std::max(1, chartWidth()) );
+    horizontalScrollBar()->setRange( 0, std::max(0, int(total_width) - chartWidth()) );
+
+    const int visible_rows = viewport()->height() / ROW_HEIGHT;
+    verticalScrollBar()->setPageStep( std::max(1, visible_rows) );
+    verticalScrollBar()->setRange( 0, std::max(0, int(_rows.size()) - visible_rows) );
+}
+
+void ReplayGanttWidget::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void ReplayGanttWidget::wheelEvent(QWheelEvent *event)
+{
+    if( !(event->modifiers() & Qt::ControlModifier) || !_timeline )
+    {
+        QAbstractScrollArea::wheelEvent(event);
+        return;
+    }
+
+    // zoom the time axis, keeping the time under the cursor in place
+    const double x = event->pos().x();
+    const double anchor_time = timeAt( x );
+    const double factor = (event->angleDelta().y() > 0) ? 1.25 : 0.8;
+
+    const double duration = _timeline->endTime() - _timeline->startTime();
+    double pixels_per_second = _pixels_per_second * factor;
+    if( duration > 0 )
+    {
+        pixels_per_second = std::min( pixels_per_second, MAX_CHART_PIXELS / duration );
+        pixels_per_second = std::max( pixels_per_second, std::max(1, chartWidth()) / duration );
+    }
+    _pixels_per_second = pixels_per_second;
+
+    updateScrollBars();
+    const double offset = (anchor_time - _timeline->startTime()) * _pixels_per_second;
+    horizontalScrollBar()->setValue( int(offset - (x - LABEL_WIDTH)) );
+    viewport()->update();
+    event->accept();
+}
+
+void ReplayGanttWidget::mousePressEvent(QMouseEvent *event)
+{
+    if( _timeline && event->button() == Qt::LeftButton && event->pos().x() > LABEL_WIDTH )
+    {
+        emit timeSelected( timeAt( event->pos().x() ) );
+    }
+    QAbstractScrollArea::mousePressEvent(event);
+}
+
+void ReplayGanttWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter( viewport() );
+    const QRect area = viewport()->rect();
+    painter.fillRect( area, palette().base() );
+
+    if( !_tree || !_timeline || _rows.empty() )
+    {
+        return;
+    }
+
+    const QColor running_color = QColor::fromRgb(250, 160, 20);
+    const QColor alternate_color = palette().alternateBase().color();
+    const int right = area.width();
+
+    const int first_row = verticalScrollBar()->value();
+    const int last_row  = std::min( int(_rows.size()),
+                                    first_row + area.height() / ROW_HEIGHT + 1 );
+
+    const double t_begin = timeAt( LABEL_WIDTH );
+    const double t_end   = timeAt( right );
+
+    for (int row = first_row; row < last_row; row++)
+    {
+        const int node_index = _rows[row];
+        const int y = (row - first_row) * ROW_HEIGHT;
+
+        if( row % 2 == 1 )
+        {
+            painter.fillRect( 0, y, right, ROW_HEIGHT, alternate_color );
+        }
+
+        const int indent = _depth[row] * INDENT_WIDTH;
+        const QRect label_rect( 4 + indent, y, LABEL_WIDTH - 8 - indent, ROW_HEIGHT );
+        const QString label = painter.fontMetrics().elidedText(
+                    _tree->node(node_index)->instance_name, Qt::ElideRight, label_rect.width() );
+        painter.setPen( palette().text().color() );
+        painter.drawText( label_rect, Qt::AlignVCenter | Qt::AlignLeft, label );
+
+        if( size_t(node_index) >= _timeline->nodesCount() )
+        {
+            continue;
+        }
+
+        const auto& intervals = _timeline->intervals(node_index);
+        size_t i = _timeline->firstIntervalEndingAfter( node_index, t_begin );
+
+        // right-most pixel already painted in this row
+        int last_x = LABEL_WIDTH - 1;
+
+        while( i < intervals.size() && intervals[i].start <= t_end )
+        {
+            const int x_start = std::max( LABEL_WIDTH, int(xAt(intervals[i].start)) );
+            int x_end = std::min( right, int(xAt(intervals[i].end)) );
+            x_end = std::max( x_end, x_start + 1 );
+
+            if( x_end <= last_x )
+            {
+                // this interval falls entirely in a pixel already painted: skip
+                // all the intervals that end before the next pixel.
+                const size_t next = _timeline->firstIntervalEndingAfter( node_index,
+                                                                         timeAt(last_x + 1) );
+                i = std::max( i + 1, next );
+                continue;
+            }
+            painter.fillRect( x_start, y + 3, x_end - x_start, ROW_HEIGHT - 6, running_color );
+            last_x = x_end;
+            i++;
+        }
+    }
+
+    painter.setPen( palette().mid().color() );
+    painter.drawLine( LABEL_WIDTH, 0, LABEL_WIDTH, area.height() );
+
+    const double cursor_x = xAt( _current_time );
+    if( cursor_x >= LABEL_WIDTH && cursor_x <= right )
+    {
+        painter.setPen( QPen( Qt::red, 1 ) );
+        painter.drawLine( QPointF(cursor_x, 0), QPointF(cursor_x, area.height()) );
+    }
+}
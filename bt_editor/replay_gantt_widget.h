@@ -0,0 +1,60 @@
+#ifndef REPLAY_GANTT_WIDGET_H
+#define REPLAY_GANTT_WIDGET_H
+
+#include <QAbstractScrollArea>
+#include "bt_editor_base.h"
+#include "replay_timeline.h"
+
+/// Node x time view of the RUNNING intervals of a replayed log.
+/// Painting is virtualized: only the visible rows are visited, and only the
+/// intervals that intersect the viewport are drawn. Intervals smaller than a
+/// pixel are merged, so that the cost of a repaint depends on the size of the
+/// viewport and not on the number of intervals.
+class ReplayGanttWidget : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit ReplayGanttWidget(QWidget *parent = nullptr);
+
+    // Both tree and timeline are owned by the caller and must outlive this widget
+    void setTimeline(const AbsBehaviorTree* tree, const ReplayTimeline* timeline);
+
+    void setCurrentTime(double timestamp);
+
+signals:
+
+    void timeSelected(double timestamp);
+
+protected:
+
+    void paintEvent(QPaintEvent *event) override;
+
+    void resizeEvent(QResizeEvent *event) override;
+
+    void wheelEvent(QWheelEvent *event) override;
+
+    void mousePressEvent(QMouseEvent *event) override;
+
+private:
+
+    void updateScrollBars();
+
+    double timeAt(double x) const;
+
+    double xAt(double timestamp) const;
+
+    int chartWidth() const;
+
+    const AbsBehaviorTree* _tree;
+    const ReplayTimeline* _timeline;
+
+    // node indexes in depth first order, one per row
+    std::vector<int> _rows;
+    std::vector<int> _depth;
+
+    double _pixels_per_second;
+    double _current_time;
+};
+
+#endif // REPLAY_GANTT_WIDGET_H
@@ -0,0 +1,293 @@
+#include "replay_timeline.h"
+#include <algorithm>
+
+void ReplayTimeline::clear()
+{
+    _intervals.clear();
+    _cumulative.clear();
+    _executions_start.clear();
+    _start_time = 0;
+    _end_time = 0;
+}
+
+void ReplayTimeline::build(size_t nodes_count,
+                           const std::vector<ReplayTransition> &transitions)
+{
+    clear();
+    _intervals.resize( nodes_count );
+
+    if( transitions.empty() )
+    {
+        return;
+    }
+    _start_time = transitions.front().timestamp;
+    _end_time   = transitions.back().timestamp;
+
+    // start time of the RUNNING interval currently open, if any
+    std::vector<double> open_since( nodes_count, -1.0 );
+
+    for (const auto& trans: transitions)
+    {
+        const size_t index = trans.index;
+        if( index >= nodes_count )
+        {
+            continue;
+        }
+        if( trans.is_tree_restart )
+        {
+            _executions_start.push_back( trans.timestamp );
+        }
+        double& since = open_since[index];
+
+        if( trans.status == NodeStatus::RUNNING )
+        {
+            if( since < 0 ) {
+                since = trans.timestamp;
+            }
+        }
+        else if( since >= 0 )
+        {
+            _intervals[index].push_back( { since, trans.timestamp } );
+            since = -1.0;
+        }
+    }
+
+    // intervals still open when the log ends
+    for (size_t index = 0; index < nodes_count; index++)
+    {
+        if( open_since[index] >= 0 )
+        {
+            _intervals[index].push_back( { open_since[index], _end_time } );
+        }
+    }
+
+    _cumulative.resize( nodes_count );
+    for (size_t index = 0; index < nodes_count; index++)
+    {
+        const auto& node_intervals = _intervals[index];
+        auto& cumulative = _cumulative[index];
+        cumulative.resize( node_intervals.size() + 1 );
+        cumulative[0] = 0;
+        for (size_t i = 0; i < node_intervals.size(); i++)
+        {
+            cumulative[i+1] = cumulative[i] + (node_intervals[i].end - node_intervals[i].start);
+        }
+    }
+}
+
+size_t ReplayTimeline::firstIntervalEndingAfter(int node_index, double t) const
+{
+    const auto& node_intervals = _intervals[node_index];
+    auto it = std::lower_bound( node_intervals.begin(), node_intervals.end(), t,
+                                [](const RunningInterval& interval, double value)
+    {
+        return interval.end < value;
+    });
+    return it - node_intervals.begin();
+}
+
+double ReplayTimeline::runningTime(int node_index, double t_begin, double t_end) const
+{
+    const auto& node_intervals = _intervals[node_index];
+    const auto& cumulative = _cumulative[node_index];
+
+    const size_t first = firstIntervalEndingAfter( node_index, t_begin );
+    // first interval starting after t_end
+    auto it = std::upper_bound( node_intervals.begin(), node_intervals.end(), t_end,
+                                [](double value, const RunningInterval& interval)
+    {
+        return value < interval.start;
+    });
+    const size_t last = it - node_intervals.begin();
+
+    if( first >= last )
+    {
+        return 0;
+    }
+    double total = cumulative[last] - cumulative[first];
+
+    // clip the intervals at the borders of the range
+    if( node_intervals[first].start < t_begin )
+    {
+        total -= t_begin - node_intervals[first].start;
+    }
+    if( node_intervals[last-1].end > t_end )
+    {
+        total -= node_intervals[last-1].end - t_end;
+    }
+    return std::max( 0.0, total );
+}
+
+std::pair<double, double> ReplayTimeline::executionRange(double timestamp) const
+{
+    double begin = _start_time;
+    double end = _end_time;
+
+    auto it = std::upper_bound( _executions_start.begin(), _executions_start.end(), timestamp );
+    if( it != _executions_start.begin() )
+    {
+        begin = *(it-1);
+    }
+    if( it != _executions_start.end() )
+    {
+        end = *it;
+    }
+    return { begin, end };
+}
+
+void UpdateRestartPoints(size_t nodes_count, std::vector<ReplayTransition> &transitions)
+{
+    const int total_nodes = nodes_count;
+    int idle_counter = total_nodes;
+    int nearest_restart_transition_index = 0;
+
+    for (size_t t = 0; t < transitions.size(); t++)
+    {
+        ReplayTransition& transition = transitions[t];
+        transition.is_tree_restart = false;
+
+        if(transition.index == 1 &&
+                (transition.status == NodeStatus::RUNNING || transition.status == NodeStatus::IDLE) &&
+                idle_counter >= total_nodes - 1){
+            transition.is_tree_restart = true;
+            nearest_restart_transition_index = t;
+        }
+
+        if(transition.prev_status != NodeStatus::IDLE && transition.status == NodeStatus::IDLE)
+            idle_counter++;
+        else if(transition.prev_status == NodeStatus::IDLE && transition.status != NodeStatus::IDLE)
+            idle_counter--;
+
+        transition.nearest_restart_transition_index = nearest_restart_transition_index;
+    }
+}
+
+//--------------------------------------------------
+
+void ReplayDecoder::clear()
+{
+    _transitions = nullptr;
+    _nodes_count = 0;
+    _interval = 1;
+    _checkpoints.clear();
+}
+
+void ReplayDecoder::reset(State &state) const
+{
+    state.shown.assign( _nodes_count, { NodeStatus::IDLE, NodeStatus::IDLE } );
+    state.last.assign( _nodes_count, NodeStatus::IDLE );
+}
+
+void ReplayDecoder::apply(State &state, const ReplayTransition &trans) const
+{
+    const size_t index = trans.index;
+    if( index >= _nodes_count )
+    {
+        return;
+    }
+    // the root becoming RUNNING resets the style of the entire tree,
+    // but not the last status of each node.
+    if( index == 1 && trans.status == NodeStatus::RUNNING )
+    {
+        std::fill( state.shown.begin(), state.shown.end(),
+                   StatusPair( NodeStatus::IDLE, NodeStatus::IDLE ) );
+    }
+    state.shown[index] = { trans.status, state.last[index] };
+    state.last[index] = trans.status;
+}
+
+void ReplayDecoder::build(size_t nodes_count,
+                          const std::vector<ReplayTransition> &transitions,
+                          size_t checkpoint_interval)
+{
+    clear();
+    _transitions = &transitions;
+    _nodes_count = nodes_count;
+
+    // Restoring a snapshot costs O(nodes_count), replaying the rows after it
+    // O(_interval): the two are balanced and the memory used by the snapshots
+    // never exceeds a few bytes per transition.
+    _interval = (checkpoint_interval > 0) ? checkpoint_interval
+                                          : std::max( size_t(64), nodes_count );
+
+    _checkpoints.reserve( transitions.size() / _interval + 1 );
+
+    State state;
+    reset( state );
+    for (size_t row = 0; row < transitions.size(); row++)
+    {
+        const auto& trans = transitions[row];
+        // the status sequence of a row starts from its nearest restart
+        if( int(row) == trans.nearest_restart_transition_index )
+        {
+            reset( state );
+        }
+        apply( state, trans );
+
+        if( row % _interval == 0 )
+        {
+            _checkpoints.push_back( state );
+        }
+    }
+}
+
+std::vector<ReplayDecoder::StatusPair> ReplayDecoder::statusAt(int row) const
+{
+    State state;
+    if( !_transitions || row < 0 || size_t(row) >= _transitions->size() )
+    {
+        reset( state );
+        return state.shown;
+    }
+    const auto& transitions = *_transitions;
+    const int restart = transitions[row].nearest_restart_transition_index;
+    const int checkpoint_row = int( (row / _interval) * _interval );
+
+    int first_row = restart;
+    if( checkpoint_row >= restart )
+    {
+        state = _checkpoints[ row / _interval ];
+        first_row = checkpoint_row + 1;
+    }
+    else{
+        reset( state );
+    }
+
+    for (int t = first_row; t <= row; t++)
+    {
+        apply( state, transitions[t] );
+    }
+    return state.shown;
+}
+
+std::vector<std::pair<int, NodeStatus>> ReplayDecoder::sequenceAt(int row) const
+{
+    const auto nodes_status = statusAt( row );
+
+    std::vector<std::pair<int, NodeStatus>> sequence;
+    sequence.reserve( nodes_status.size() * 2 );
+
+    // For each node, the previous status first, then the current one.
+    // The root goes first, because its RUNNING status resets the whole tree.
+    auto appendNode = [&](int index)
+    {
+        const StatusPair& status = nodes_status[index];
+        if( status.second != NodeStatus::IDLE )
+        {
+            sequence.push_back( { index, status.second } );
+        }
+        sequence.push_back( { index, status.first } );
+    };
+
+    if( nodes_status.size() > 1 )
+    {
+        appendNode( 1 );
+    }
+    for (int index = 0; index < int(nodes_status.size()); index++)
+    {
+        if( index != 1 ){
+            appendNode( index );
+        }
+    }
+    return sequence;
+}
@@ -0,0 +1,114 @@
+#ifndef REPLAY_TIMELINE_H
+#define REPLAY_TIMELINE_H
+
+#include <vector>
+#include <cstdint>
+#include "bt_editor_base.h"
+
+struct ReplayTransition{
+    int32_t index;
+    double timestamp;
+    NodeStatus prev_status;
+    NodeStatus status;
+    bool is_tree_restart;
+    int nearest_restart_transition_index;
+};
+
+// Set is_tree_restart and nearest_restart_transition_index of each transition
+void UpdateRestartPoints(size_t nodes_count, std::vector<ReplayTransition>& transitions);
+
+struct RunningInterval{
+    double start;
+    double end;
+};
+
+/// Per-node intervals of time spent in RUNNING state, precomputed once
+/// when a log is loaded. Intervals of the same node never overlap and are
+/// sorted by time, therefore they can be searched with a binary search.
+class ReplayTimeline
+{
+public:
+
+    void clear();
+
+    void build(size_t nodes_count, const std::vector<ReplayTransition>& transitions);
+
+    size_t nodesCount() const { return _intervals.size(); }
+
+    const std::vector<RunningInterval>& intervals(int node_index) const
+    {
+        return _intervals[node_index];
+    }
+
+    double startTime() const { return _start_time; }
+
+    double endTime() const { return _end_time; }
+
+    // Index of the first interval of the node that ends at or after time t
+    size_t firstIntervalEndingAfter(int node_index, double t) const;
+
+    // Total time spent by the node in RUNNING state within [t_begin, t_end].
+    // It costs O(log N), thanks to the cumulative durations of the intervals.
+    double runningTime(int node_index, double t_begin, double t_end) const;
+
+    // Start time of each execution of the tree (a restart of the root)
+    const std::vector<double>& executionsStart() const { return _executions_start; }
+
+    // Time range of the execution that contains the given timestamp
+    std::pair<double,double> executionRange(double timestamp) const;
+
+private:
+    std::vector< std::vector<RunningInterval> > _intervals;
+    // _cumulative[node][i] is the total duration of the first i intervals
+    std::vector< std::vector<double> > _cumulative;
+    std::vector<double> _executions_start;
+    double _start_time = 0;
+    double _end_time = 0;
+};
+
+/// Status of every node at any row of a log, without replaying all the
+/// transitions since the beginning of the execution.
+/// A snapshot of the whole tree is stored every few rows; the state at a
+/// given row is the nearest snapshot plus the transitions that follow it.
+class ReplayDecoder
+{
+public:
+
+    typedef std::pair<NodeStatus, NodeStatus> StatusPair; // (status, previous status)
+
+    void clear();
+
+    // The transitions must not change until the next call to build().
+    // If checkpoint_interval is 0, it is chosen from the size of the tree.
+    void build(size_t nodes_count, const std::vector<ReplayTransition>& transitions,
+               size_t checkpoint_interval = 0);
+
+    size_t nodesCount() const { return _nodes_count; }
+
+    // (status, previous status) of each node after the given row,
+    // with the same semantic of ResolveNodesStatus()
+    std::vector<StatusPair> statusAt(int row) const;
+
+    // Changes to pass to MainWindow::onChangeNodesStatus() to show the state
+    // of the tree at the given row: at most two entries per node.
+    std::vector<std::pair<int, NodeStatus>> sequenceAt(int row) const;
+
+private:
+
+    struct State{
+        std::vector<StatusPair> shown;
+        std::vector<NodeStatus> last;
+    };
+
+    void reset(State& state) const;
+
+    void apply(State& state, const ReplayTransition& trans) const;
+
+    const std::vector<ReplayTransition>* _transitions = nullptr;
+    size_t _nodes_count = 0;
+    size_t _interval = 1;
+    // _checkpoints[i] is the state after the row i*_interval
+    std::vector<State> _checkpoints;
+};
+
+#endif // REPLAY_TIMELINE_H
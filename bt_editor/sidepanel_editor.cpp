@@ -318,11 +318,11 @@ void SidepanelEditor::on_buttonUpload_clicked()
             if(!container) { continue; }
             const auto scene = container->scene();
 
-            auto abs_tree = BuildTreeFromScene(container->scene());
+            const auto& abs_tree = container->loadedTree();
             auto abs_root = abs_tree.rootNode();
 
             if( abs_root->children_index.size() == 1 &&
-                abs_root->model.registration_ID == "Root"  )
+                abs_root->model->registration_ID == "Root"  )
             {
                 // move to the child of ROOT
                 abs_root = abs_tree.node( abs_root->children_index.front() );
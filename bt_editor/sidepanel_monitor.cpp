@@ -6,6 +6,7 @@
 #include <QTimer>
 #include <QLabel>
 #include <QDebug>
+#include <set>
 
 #include "mainwindow.h"
 #include "utils.h"
@@ -52,25 +53,36 @@ void SidepanelMonitor::on_timer()
             const uint32_t num_transitions = flatbuffers::ReadScalar<uint32_t>( &buffer[4+header_size] );
             
             std::vector<std::pair<int, NodeStatus>> node_status;
+
+            auto indexOf = [this](uint16_t uid)
+            {
+                const int index = _tree_view.indexOf( uid );
+                if( index < 0 )
+                {
+                    throw std::out_of_range("unknown UID");
+                }
+                return index;
+            };
+
             // check uid in the index, if failed load tree from server
             try{
                 for(size_t offset = 4; offset < header_size +4; offset +=3 )
                 {
                     const uint16_t uid = flatbuffers::ReadScalar<uint16_t>(&buffer[offset]);
-                    _uid_to_index.at(uid);
+                    indexOf(uid);
                 }
                 
                 for(size_t t=0; t < num_transitions; t++)
                 {
                     size_t offset = 8 + header_size + 12*t;
                     const uint16_t uid = flatbuffers::ReadScalar<uint16_t>(&buffer[offset+8]);
-                    _uid_to_index.at(uid);
+                    indexOf(uid);
                 }
 
                 for(size_t offset = 4; offset < header_size +4; offset +=3 )
                 {
                     const uint16_t uid = flatbuffers::ReadScalar<uint16_t>(&buffer[offset]);
-                    const uint16_t index = _uid_to_index.at(uid);
+                    const int index = indexOf(uid);
                     AbstractTreeNode* node = _loaded_tree.node( index );
                     node->status = convert(flatbuffers::ReadScalar<Serialization::NodeStatus>(&buffer[offset+2] ));
                 }
@@ -84,7 +96,7 @@ void SidepanelMonitor::on_timer()
                     // const double t_usec = flatbuffers::ReadScalar<uint32_t>( &buffer[offset+4] );
                     // double timestamp = t_sec + t_usec* 0.000001;
                     const uint16_t uid = flatbuffers::ReadScalar<uint16_t>(&buffer[offset+8]);
-                    const uint16_t index = _uid_to_index.at(uid);
+                    const int index = indexOf(uid);
                     // NodeStatus prev_status = convert(flatbuffers::ReadScalar<Serialization::NodeStatus>(&buffer[index+10] ));
                     NodeStatus status  = convert(flatbuffers::ReadScalar<Serialization::NodeStatus>(&buffer[offset+11] ));
 
@@ -138,42 +150,48 @@ bool SidepanelMonitor::getTreeFromServer()
             return false;
         }
 
-        const char* buffer = reinterpret_cast<const char*>(reply.data());
-        auto fb_behavior_tree = Serialization::GetBehaviorTree( buffer );
+        // deep copy: the reply is released when it goes out of scope
+        const QByteArray buffer( reinterpret_cast<const char*>(reply.data()), int(reply.size()) );
 
-        auto res_pair = BuildTreeFromFlatbuffers( fb_behavior_tree );
+        // if the tree is the one already shown, only the status must be updated
+        if( _tree_view.load( buffer ) )
+        {
+            try {
+                _loaded_tree = _tree_view.toAbsTree();
 
-        _loaded_tree  = std::move( res_pair.first );
-        _uid_to_index = std::move( res_pair.second );
+                // add new models to registry. The nodes share their models.
+                std::set<const NodeModel*> added_models;
+                for(const auto& tree_node: _loaded_tree.nodes())
+                {
+                    const auto& registration_ID = tree_node.model->registration_ID;
+                    if( BuiltinNodeModels().count(registration_ID) == 0 &&
+                        added_models.insert( tree_node.model.get() ).second )
+                    {
+                        addNewModel( *tree_node.model );
+                    }
+                }
 
-        // add new models to registry
-        for(const auto& tree_node: _loaded_tree.nodes())
-        {
-            const auto& registration_ID = tree_node.model.registration_ID;
-            if( BuiltinNodeModels().count(registration_ID) == 0)
-            {
-                addNewModel( tree_node.model );
+                loadBehaviorTree( _loaded_tree, "BehaviorTree" );
+            }
+            catch (std::exception& err) {
+                _tree_view.clear();
+                QMessageBox messageBox;
+                messageBox.critical(this,"Error Connecting to remote server", err.what() );
+                messageBox.show();
+                return false;
             }
-        }
-
-        try {
-            loadBehaviorTree( _loaded_tree, "BehaviorTree" );
-        }
-        catch (std::exception& err) {
-            QMessageBox messageBox;
-            messageBox.critical(this,"Error Connecting to remote server", err.what() );
-            messageBox.show();
-            return false;
         }
 
         std::vector<std::pair<int, NodeStatus>> node_status;
-        node_status.reserve(_loaded_tree.nodesCount());
+        node_status.reserve(_tree_view.nodesCount());
 
         //  qDebug() << "--------";
 
-        for(size_t t=0; t < _loaded_tree.nodesCount(); t++)
+        for(size_t t=0; t < _tree_view.nodesCount(); t++)
         {
-            node_status.push_back( { t, _loaded_tree.nodes()[t].status } );
+            const NodeStatus status = _tree_view.status(t);
+            _loaded_tree.node(t)->status = status;
+            node_status.push_back( { t, status } );
         }
         emit changeNodeStyle( "BehaviorTree", node_status );
     }
@@ -223,6 +241,8 @@ void SidepanelMonitor::on_Connect()
                 _zmq_subscriber.setsockopt(ZMQ_SUBSCRIBE, "", 0);
                 _zmq_subscriber.setsockopt(ZMQ_RCVTIMEO,&timeout_ms, sizeof(int) );
 
+                // the scene might have changed while disconnected
+                _tree_view.clear();
                 if( !getTreeFromServer() )
                 {
                     failed = true;
@@ -5,6 +5,7 @@
 #include <zmq.hpp>
 
 #include "bt_editor_base.h"
+#include "flatbuffer_tree_view.h"
 
 namespace Ui {
 class SidepanelMonitor;
@@ -50,7 +51,7 @@ private:
     QTimer* _timer;
     int _msg_count;
     AbsBehaviorTree _loaded_tree;
-    std::unordered_map<int, int> _uid_to_index;
+    FlatbufferTreeView _tree_view;
 
     bool getTreeFromServer();
 
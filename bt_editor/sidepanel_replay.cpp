@@ -12,19 +12,53 @@
 #include <QModelIndex>
 #include <QTimer>
 #include <QMessageBox>
+#include <QTabWidget>
+#include <QProgressDialog>
+#include <set>
+#include <map>
 
 #include "bt_editor_base.h"
 #include "mainwindow.h"
 #include "utils.h"
+#include "replay_gantt_widget.h"
+#include "replay_flamegraph_widget.h"
+#include "replay_exporter.h"
 
+namespace {
+
+// The files of a session may be hours apart: on the timeline, the gap
+// between the end of a file and the beginning of the next one is capped.
+const double MAX_FILE_GAP = 1.0;
+
+}
 
 SidepanelReplay::SidepanelReplay(QWidget *parent) :
     QFrame(parent),
     ui(new Ui::SidepanelReplay),
+    _current_file(-1),
+    _timeline_origin(0),
+    _loaded_header_hash(0),
+    _compare_row(-1),
     _prev_row(-1),
     _parent(parent)
 {
     ui->setupUi(this);
+    ui->comboBoxLogFile->setHidden( true );
+    ui->comboBoxAlignment->setHidden( true );
+    ui->pushButtonCloseCompare->setHidden( true );
+
+    _timeline_window = new QTabWidget(this);
+    _timeline_window->setWindowFlags( Qt::Window );
+    _timeline_window->setWindowTitle( "Timeline" );
+    _timeline_window->resize( 900, 500 );
+
+    _gantt_widget = new ReplayGanttWidget(_timeline_window);
+    _flamegraph_widget = new ReplayFlameGraphWidget(_timeline_window);
+    _timeline_window->addTab( _gantt_widget, "RUNNING intervals" );
+    _timeline_window->addTab( _flamegraph_widget, "Time per subtree" );
+
+    connect( _gantt_widget, &ReplayGanttWidget::timeSelected,
+             this, &SidepanelReplay::onTimeSelected );
 
     _table_model = new QStandardItemModel(0,4, this);
 
@@ -57,6 +91,10 @@ void SidepanelReplay::clear()
 {
     _table_model->setColumnCount(4);
     _table_model->setRowCount(0);
+
+    // the scene is cleared too, the header must be loaded again
+    _tree_view.clear();
+    closeComparison();
 }
 
 void SidepanelReplay::updateTableModel(const AbsBehaviorTree& locaded_tree)
@@ -95,18 +133,34 @@ void SidepanelReplay::updateTableModel(const AbsBehaviorTree& locaded_tree)
     if(  transitions_count > 0)
     {
         double previous_timestamp = 0;
-        const double first_timestamp = _transitions.front().timestamp;
+        const double first_timestamp = _timeline_origin;
+
+        // the timestamps of each file of a session are shifted by its offset
+        std::vector<std::pair<int,double>> file_offsets;
+        for (const auto& log_file: _session_files)
+        {
+            if( log_file.first_row >= 0 ){
+                file_offsets.push_back( {log_file.first_row, log_file.offset} );
+            }
+        }
+        size_t file = 0;
 
         for(size_t row=0; row < transitions_count; row++)
         {
             auto& trans = _transitions[row];
             auto node  = locaded_tree.node( trans.index );
 
+            while( file+1 < file_offsets.size() && file_offsets[file+1].first <= int(row) )
+            {
+                file++;
+            }
+            const double offset = file_offsets.empty() ? 0.0 : file_offsets[file].second;
+
             QString timestamp;
             timestamp.sprintf("%.3f", trans.timestamp - first_timestamp);
 
             auto timestamp_item = new QStandardItem( timestamp );
-            timestamp.sprintf("absolute time: %.3f", trans.timestamp);
+            timestamp.sprintf("absolute time: %.3f", trans.timestamp - offset);
             timestamp_item->setToolTip( timestamp );
 
             if(  (trans.timestamp - previous_timestamp) >= 0.001 || row == transitions_count-1)
@@ -177,32 +231,85 @@ void SidepanelReplay::on_LoadLog()
 
 void SidepanelReplay::loadLog(const QByteArray &content)
 {
+    // a single log replaces the current session, if any
+    _session_files.clear();
+    _current_file = -1;
+    {
+        QSignalBlocker blocker( ui->comboBoxLogFile );
+        ui->comboBoxLogFile->clear();
+    }
+    ui->comboBoxLogFile->setHidden( true );
+
     const char* buffer = reinterpret_cast<const char*>(content.data());
 
-    // how many bytes did we read off the disk (uoffset_t aka uint32_t)
-    const auto read_bytes = content.size();
+    size_t bt_header_size = 0;
+    if( !loadHeader( buffer, content.size(), &bt_header_size ) )
+    {
+        return;
+    }
 
+    _transitions.clear();
+
+    const size_t records_offset = 4 + bt_header_size;
+    const DecodeResult result = decodeTransitions( &buffer[records_offset],
+                                                   size_t(content.size()) - records_offset,
+                                                   _tree_view.uidLookup(), &_transitions );
+    UpdateRestartPoints( _loaded_tree.nodesCount(), _transitions );
+
+    if( result.skipped_records > 0 || result.trailing_bytes > 0 )
+    {
+        reportCorruptRegions( result );
+    }
+
+    _timeline_origin = _transitions.empty() ? 0.0 : _transitions.front().timestamp;
+    _timepoint.clear();
+    _prev_row = -1;
+    updateTimeline();
+    updateTableModel(_loaded_tree);
+
+
+    // We need to lock the nodes after they are loaded
+    auto main_win = dynamic_cast<MainWindow*>( _parent );
+    main_win->lockEditing(true);
+}
+
+bool SidepanelReplay::loadHeader(const char *buffer, size_t read_bytes, size_t *header_size)
+{
     // we need at least 4 bytes to read the bt_header_size
     if( read_bytes < 4 ) {
         QMessageBox::warning( this, "Log file is empty",
                              "Failed to load this file.\n"
                              "This Log file is empty");
-        return;
+        return false;
     }
     
     // read the length of the header section from the file
     const size_t bt_header_size = flatbuffers::ReadScalar<uint32_t>(buffer);
 
     // if the length of the header goes past the end of the file, it is invalid
-    if( (bt_header_size == 0) || (bt_header_size > read_bytes) ) {
+    if( (bt_header_size == 0) || (bt_header_size > read_bytes - 4) ) {
         QMessageBox::warning( this, "Log file is corrupt",
                              "Failed to load this file.\n"
                              "This Log file corrupted or truncated");
-        return;
+        return false;
     }
+    *header_size = bt_header_size;
 
+    // Logs of the same mission usually share the very same header:
+    // in that case the tree (and the scene) already loaded can be reused.
+    const QByteArray header = QByteArray::fromRawData( buffer+4, int(bt_header_size) );
+    const uint header_hash = qHash( header );
+
+    if( !_tree_view.empty() &&
+        header_hash == _loaded_header_hash && header == _tree_view.buffer() )
+    {
+        return true;
+    }
+
+    // Only the header is a flatbuffer. The transitions that follow it are plain
+    // fixed-size records: they are validated in bulk by decodeTransitions().
     flatbuffers::Verifier verifier( reinterpret_cast<const uint8_t*>(buffer+4),
-                                   size_t(content.size() -4));
+                                    bt_header_size );
 
     bool valid_tree = Serialization::VerifyBehaviorTreeBuffer(verifier);
     if( ! valid_tree )
@@ -210,76 +317,406 @@ void SidepanelReplay::loadLog(const QByteArray &content)
         QMessageBox::warning( this, "Flatbuffer verification failed",
                              "Failed to load this file.\n"
                              "Its format is not compatible with the current one");
+        return false;
+    }
+
+    // a different tree: the log being compared doesn't match anymore
+    closeComparison();
+
+    // deep copy: the buffer belongs to the caller
+    _tree_view.load( QByteArray( buffer+4, int(bt_header_size) ) );
+    _loaded_header_hash = header_hash;
+
+    _loaded_tree = _tree_view.toAbsTree();
+
+    // the nodes share their models: add each of them once
+    std::set<const NodeModel*> added_models;
+    for (const auto& tree_node: _loaded_tree.nodes() )
+    {
+        const QString& ID = tree_node.model->registration_ID;
+        if( BuiltinNodeModels().count( ID ) == 0 &&
+            added_models.insert( tree_node.model.get() ).second )
+        {
+            emit addNewModel( *tree_node.model );
+        }
+    }
+
+    emit loadBehaviorTree( _loaded_tree, "BehaviorTree" );
+    return true;
+}
+
+void SidepanelReplay::on_pushButtonLoadSession_clicked()
+{
+    QSettings settings;
+    QString directory_path  = settings.value("SidepanelReplay.lastLoadDirectory",
+                                             QDir::homePath() ).toString();
+
+    directory_path = QFileDialog::getExistingDirectory(this, tr("Open Log Session"),
+                                                       directory_path);
+    if( directory_path.isEmpty() )
+    {
         return;
     }
+    settings.setValue("SidepanelReplay.lastLoadDirectory", directory_path);
+    settings.sync();
+
+    QDir directory( directory_path );
+    QStringList files;
+    for(const auto& name: directory.entryList( {"*.fbl"}, QDir::Files, QDir::Name ) )
+    {
+        files.push_back( directory.absoluteFilePath(name) );
+    }
+    loadSession( files );
+}
 
+bool SidepanelReplay::scanLogFile(const QString &path, LogFile *log_file)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)){
+        return false;
+    }
+    const qint64 file_size = file.size();
 
-    auto fb_behavior_tree = Serialization::GetBehaviorTree( &buffer[4] );
+    char size_buffer[4];
+    if( file.read( size_buffer, 4 ) != 4 )
+    {
+        return false;
+    }
+    const uint32_t header_size = flatbuffers::ReadScalar<uint32_t>( size_buffer );
+    if( header_size == 0 || header_size > file_size - 4 )
+    {
+        return false;
+    }
 
+    const QByteArray header = file.read( header_size );
 
-    auto res_pair = BuildTreeFromFlatbuffers( fb_behavior_tree );
+    log_file->path = path;
+    log_file->header_hash = qHash( header );
+    log_file->records_count = (file_size - 4 - header_size) / 12;
+    log_file->first_timestamp = 0;
+    log_file->last_timestamp = 0;
+    log_file->offset = 0;
+    log_file->first_row = -1;
 
-    _loaded_tree  = res_pair.first;
-    const auto& uid_to_index = res_pair.second;
+    // only the first and the last records are read here, the rest is
+    // loaded when the file is selected.
+    auto readTimestamp = [&file](qint64 offset) -> double
+    {
+        char data[8];
+        file.seek( offset );
+        if( file.read( data, 8 ) != 8 ) {
+            return 0;
+        }
+        const double t_sec  = flatbuffers::ReadScalar<uint32_t>( &data[0] );
+        const double t_usec = flatbuffers::ReadScalar<uint32_t>( &data[4] );
+        return t_sec + t_usec* 0.000001;
+    };
 
-    for (const auto& tree_node: _loaded_tree.nodes() )
+    if( log_file->records_count > 0 )
     {
-        const QString& ID = tree_node.model.registration_ID;
-        if( BuiltinNodeModels().count( ID ) == 0)
+        const qint64 records_offset = 4 + header_size;
+        log_file->first_timestamp = readTimestamp( records_offset );
+        log_file->last_timestamp  = readTimestamp( records_offset +
+                                                   (log_file->records_count-1) * 12 );
+    }
+    return true;
+}
+
+void SidepanelReplay::loadSession(const QStringList &files)
+{
+    std::vector<LogFile> session;
+    QStringList skipped_files;
+    for (const auto& path: files)
+    {
+        LogFile log_file;
+        if( scanLogFile( path, &log_file ) )
         {
-            emit addNewModel( tree_node.model );
+            session.push_back( log_file );
+        }
+        else{
+            skipped_files.push_back( QFileInfo(path).fileName() );
         }
     }
 
-    emit loadBehaviorTree( _loaded_tree, "BehaviorTree" );
+    if( session.empty() )
+    {
+        QMessageBox::warning( this, "No valid log",
+                              "No valid log file (*.fbl) was found in this directory");
+        return;
+    }
+    if( !skipped_files.empty() )
+    {
+        QMessageBox::warning( this, "Invalid log files skipped",
+                              QString("These files are not valid logs and are not "
+                                      "part of the session:\n  %1")
+                              .arg( skipped_files.join("\n  ") ) );
+    }
 
-    _transitions.clear();
-    _transitions.reserve( (content.size() - 4 - bt_header_size) / 12 );
+    std::stable_sort( session.begin(), session.end(),
+                      [](const LogFile& a, const LogFile& b)
+    {
+        return a.first_timestamp < b.first_timestamp;
+    });
+
+    // One timeline for each tree, on the timestamps of its first file:
+    // each file follows the previous one of the same tree, after the
+    // gap between them, at most MAX_FILE_GAP.
+    struct TimelineEnd{
+        double last_timestamp;
+        double end;
+    };
+    std::map<uint, TimelineEnd> timeline_ends;
+    std::map<uint, double> timeline_origins;
+
+    for (auto& log_file: session)
+    {
+        auto end_it = timeline_ends.find( log_file.header_hash );
+        if( end_it == timeline_ends.end() )
+        {
+            log_file.offset = 0;
+            timeline_origins[log_file.header_hash] = log_file.first_timestamp;
+        }
+        else{
+            const double gap = log_file.first_timestamp - end_it->second.last_timestamp;
+            log_file.offset = end_it->second.end + std::max( 0.0, std::min( MAX_FILE_GAP, gap ) )
+                              - log_file.first_timestamp;
+        }
+        timeline_ends[log_file.header_hash] = { log_file.last_timestamp,
+                                                 log_file.last_timestamp + log_file.offset };
+    }
 
-    int idle_counter = _loaded_tree.nodes().size();
-    const int total_nodes = _loaded_tree.nodes().size();
-    int nearest_restart_transition_index = 0;
+    _session_files = std::move(session);
+    _current_file = -1;
 
-    for (size_t offset = 4+bt_header_size; offset < content.size(); offset += 12)
+    QSignalBlocker blocker( ui->comboBoxLogFile );
+    ui->comboBoxLogFile->clear();
+    for (const auto& log_file: _session_files)
     {
-        Transition transition;
-        const double t_sec  = flatbuffers::ReadScalar<uint32_t>( &buffer[offset] );
-        const double t_usec = flatbuffers::ReadScalar<uint32_t>( &buffer[offset+4] );
-        double timestamp = t_sec + t_usec* 0.000001;
-        transition.timestamp = timestamp;
-        const uint16_t uid = flatbuffers::ReadScalar<uint16_t>(&buffer[offset+8]);
-        transition.index = uid_to_index.at(uid);
-        transition.prev_status = convert(flatbuffers::ReadScalar<Serialization::NodeStatus>(&buffer[offset+10] ));
-        transition.status      = convert(flatbuffers::ReadScalar<Serialization::NodeStatus>(&buffer[offset+11] ));
-        transition.is_tree_restart = false;
+        // relative to the beginning of the timeline of the file
+        const double begin = log_file.first_timestamp + log_file.offset;
+        const double end   = log_file.last_timestamp  + log_file.offset;
+        const double origin = timeline_origins[log_file.header_hash];
+        QString text;
+        text.sprintf(" [%.3f - %.3f]", begin - origin, end - origin );
+        ui->comboBoxLogFile->addItem( QFileInfo(log_file.path).fileName() + text );
+    }
+    ui->comboBoxLogFile->setHidden( false );
+    ui->comboBoxLogFile->setCurrentIndex( 0 );
+
+    loadSessionFile( 0 );
+}
+
+bool SidepanelReplay::loadSessionFile(int file_index)
+{
+    if( file_index < 0 || file_index >= int(_session_files.size()) )
+    {
+        return false;
+    }
+    if( _session_files[file_index].first_row < 0 &&
+        !loadSessionTimeline( _session_files[file_index].header_hash ) )
+    {
+        return false;
+    }
+    const int row = _session_files[file_index].first_row;
+    if( row < 0 )
+    {
+        return false;
+    }
+
+    _current_file = file_index;
+    if( ui->comboBoxLogFile->currentIndex() != file_index )
+    {
+        QSignalBlocker blocker( ui->comboBoxLogFile );
+        ui->comboBoxLogFile->setCurrentIndex( file_index );
+    }
+
+    if( row < int(_transitions.size()) )
+    {
+        onRowChanged( row );
+        updatedSpinAndSlider( row );
+        ui->tableView->scrollTo( _table_model->index(row,0), QAbstractItemView::PositionAtTop );
+    }
+    return true;
+}
+
+bool SidepanelReplay::loadSessionTimeline(uint header_hash)
+{
+    std::vector<Transition> transitions;
+    bool tree_loaded = false;
+
+    for (auto& log_file: _session_files)
+    {
+        log_file.first_row = -1;
+    }
+
+    for (auto& log_file: _session_files)
+    {
+        if( log_file.header_hash != header_hash )
+        {
+            continue;
+        }
+        QFile file( log_file.path );
+        if (!file.open(QIODevice::ReadOnly)){
+            continue;
+        }
+        const QByteArray content = file.readAll();
+        const char* buffer = content.data();
 
-        if(transition.index == 1 &&
-                (transition.status == NodeStatus::RUNNING || transition.status == NodeStatus::IDLE) &&
-                idle_counter >= total_nodes - 1){
-            transition.is_tree_restart = true;
-            nearest_restart_transition_index = _transitions.size();
+        size_t bt_header_size = 0;
+        if( !tree_loaded )
+        {
+            if( !loadHeader( buffer, content.size(), &bt_header_size ) )
+            {
+                continue;
+            }
+            tree_loaded = true;
+            _timeline_origin = log_file.first_timestamp + log_file.offset;
+        }
+        else
+        {
+            // the same hash, but maybe not the same tree
+            bt_header_size = (content.size() >= 4) ? flatbuffers::ReadScalar<uint32_t>(buffer) : 0;
+            if( bt_header_size == 0 || bt_header_size > size_t(content.size()) - 4 ||
+                QByteArray::fromRawData( buffer+4, int(bt_header_size) ) != _tree_view.buffer() )
+            {
+                continue;
+            }
         }
 
-        if(transition.prev_status != NodeStatus::IDLE && transition.status == NodeStatus::IDLE)
-            idle_counter++;
-        else if(transition.prev_status == NodeStatus::IDLE && transition.status != NodeStatus::IDLE)
-            idle_counter--;
+        log_file.first_row = int( transitions.size() );
+        const size_t records_offset = 4 + bt_header_size;
+        const DecodeResult result = decodeTransitions( &buffer[records_offset],
+                                                       size_t(content.size()) - records_offset,
+                                                       _tree_view.uidLookup(), &transitions );
+        for (size_t row = log_file.first_row; row < transitions.size(); row++)
+        {
+            transitions[row].timestamp += log_file.offset;
+        }
 
-        transition.nearest_restart_transition_index = nearest_restart_transition_index;
+        if( result.skipped_records > 0 || result.trailing_bytes > 0 )
+        {
+            reportCorruptRegions( result );
+        }
+    }
 
-        _transitions.push_back(transition);
+    if( !tree_loaded )
+    {
+        return false;
     }
 
+    _transitions = std::move(transitions);
+    UpdateRestartPoints( _loaded_tree.nodesCount(), _transitions );
+
     _timepoint.clear();
     _prev_row = -1;
+    updateTimeline();
     updateTableModel(_loaded_tree);
 
-
     // We need to lock the nodes after they are loaded
     auto main_win = dynamic_cast<MainWindow*>( _parent );
     main_win->lockEditing(true);
+    return true;
+}
+
+void SidepanelReplay::on_comboBoxLogFile_currentIndexChanged(int index)
+{
+    if( index != _current_file )
+    {
+        ui->pushButtonPlay->setChecked(false);
+        loadSessionFile( index );
+    }
+}
+
+SidepanelReplay::DecodeResult
+SidepanelReplay::decodeTransitions(const char* buffer, size_t size,
+                                   const std::vector<int32_t>& uid_lookup,
+                                   std::vector<Transition>* transitions)
+{
+    // Each record is: t_sec (uint32), t_usec (uint32), uid (uint16),
+    // prev_status (int8), status (int8).
+    const size_t RECORD_SIZE = 12;
+    const uint8_t MAX_STATUS = static_cast<uint8_t>( Serialization::NodeStatus::MAX );
+
+    DecodeResult result;
+    const size_t records_count = size / RECORD_SIZE;
+    result.trailing_bytes = size % RECORD_SIZE;
+
+    transitions->reserve( transitions->size() + records_count );
+
+    // First record of the corrupt region currently being scanned, if any
+    long corrupt_begin = -1;
+
+    for (size_t record = 0; record < records_count; record++)
+    {
+        const char* data = &buffer[ record * RECORD_SIZE ];
+
+        const uint16_t uid   = flatbuffers::ReadScalar<uint16_t>( &data[8] );
+        const uint8_t prev   = flatbuffers::ReadScalar<uint8_t>( &data[10] );
+        const uint8_t status = flatbuffers::ReadScalar<uint8_t>( &data[11] );
+
+        const bool valid = uid < uid_lookup.size() &&
+                           uid_lookup[uid] >= 0 &&
+                           prev <= MAX_STATUS &&
+                           status <= MAX_STATUS;
+        if( !valid )
+        {
+            if( corrupt_begin < 0 ){
+                corrupt_begin = record;
+            }
+            result.skipped_records++;
+            continue;
+        }
+        if( corrupt_begin >= 0 )
+        {
+            result.corrupt_regions.push_back( { corrupt_begin, long(record) - 1 } );
+            corrupt_begin = -1;
+        }
+
+        const double t_sec  = flatbuffers::ReadScalar<uint32_t>( &data[0] );
+        const double t_usec = flatbuffers::ReadScalar<uint32_t>( &data[4] );
+
+        Transition transition;
+        transition.timestamp = t_sec + t_usec* 0.000001;
+        transition.index = uid_lookup[uid];
+        transition.prev_status = convert( static_cast<Serialization::NodeStatus>(prev) );
+        transition.status      = convert( static_cast<Serialization::NodeStatus>(status) );
+        transition.is_tree_restart = false;
+        transition.nearest_restart_transition_index = 0;
+        transitions->push_back(transition);
+    }
+
+    if( corrupt_begin >= 0 )
+    {
+        result.corrupt_regions.push_back( { corrupt_begin, long(records_count) - 1 } );
+    }
+    return result;
 }
 
+void SidepanelReplay::reportCorruptRegions(const DecodeResult& result)
+{
+    QString details;
+    const size_t MAX_LISTED_REGIONS = 10;
+
+    for (size_t i = 0; i < result.corrupt_regions.size() && i < MAX_LISTED_REGIONS; i++)
+    {
+        const auto& region = result.corrupt_regions[i];
+        details += QString("\n  records %1 - %2").arg(region.first).arg(region.second);
+    }
+    if( result.corrupt_regions.size() > MAX_LISTED_REGIONS )
+    {
+        details += QString("\n  ... and %1 more regions")
+                .arg( result.corrupt_regions.size() - MAX_LISTED_REGIONS );
+    }
+    if( result.trailing_bytes > 0 )
+    {
+        details += QString("\n  %1 trailing bytes (truncated record)").arg(result.trailing_bytes);
+    }
+
+    QMessageBox::warning( this, "Log file is partially corrupt",
+                          QString("%1 transitions were skipped because they refer to "
+                                  "unknown nodes or contain an invalid status:%2")
+                          .arg(result.skipped_records).arg(details) );
+}
 
 void SidepanelReplay::on_spinBox_valueChanged(int value)
 {
@@ -347,21 +784,31 @@ void SidepanelReplay::onRowChanged(int current_row)
 
     const QString bt_name("BehaviorTree");
 
-    std::vector<std::pair<int, NodeStatus>>  node_status;
-    for(size_t index = 0; index < _loaded_tree.nodes().size(); index++ )
+    emit changeNodeStyle( bt_name, _decoder.sequenceAt(current_row) );
+
+    _prev_row = current_row;
+
+    // the file of the session the row belongs to
+    int current_file = -1;
+    for (int file = 0; file < int(_session_files.size()); file++)
     {
-        node_status.push_back( { index, NodeStatus::IDLE} );
+        const int first_row = _session_files[file].first_row;
+        if( first_row >= 0 && first_row <= current_row )
+        {
+            current_file = file;
+        }
     }
-
-    for (int t = _transitions[current_row].nearest_restart_transition_index; t <= current_row; t++)
+    if( current_file >= 0 && current_file != _current_file )
     {
-        auto& trans = _transitions[t];
-        node_status.push_back( { trans.index, trans.status} );
+        _current_file = current_file;
+        QSignalBlocker blocker( ui->comboBoxLogFile );
+        ui->comboBoxLogFile->setCurrentIndex( current_file );
     }
 
-    emit changeNodeStyle( bt_name, node_status );
+    _gantt_widget->setCurrentTime( _transitions[current_row].timestamp );
+    _flamegraph_widget->setCurrentTime( _transitions[current_row].timestamp );
 
-    _prev_row = current_row;
+    updateComparison( current_row );
 }
 
 void SidepanelReplay::updatedSpinAndSlider(int row)
@@ -491,6 +938,110 @@ void SidepanelReplay::onPlayUpdate()
     _play_timer->start(delay_relative);
 }
 
+void SidepanelReplay::updateTimeline()
+{
+    _timeline.build( _loaded_tree.nodesCount(), _transitions );
+    _decoder.build( _loaded_tree.nodesCount(), _transitions );
+
+    _restart_rows.clear();
+    for (size_t row = 0; row < _transitions.size(); row++)
+    {
+        if( _transitions[row].is_tree_restart ){
+            _restart_rows.push_back( row );
+        }
+    }
+    _compare_row = -1;
+    _gantt_widget->setTimeline( &_loaded_tree, &_timeline );
+    _flamegraph_widget->setTimeline( &_loaded_tree, &_timeline );
+}
+
+void SidepanelReplay::on_pushButtonTimeline_clicked()
+{
+    _timeline_window->show();
+    _timeline_window->raise();
+    _timeline_window->activateWindow();
+}
+
+void SidepanelReplay::on_pushButtonExport_clicked()
+{
+    auto main_win = dynamic_cast<MainWindow*>( _parent );
+    auto container = main_win->getTabByName("BehaviorTree");
+    if( _timepoint.empty() || !container )
+    {
+        return;
+    }
+
+    QSettings settings;
+    QString directory_path  = settings.value("SidepanelReplay.lastExportDirectory",
+                                             QDir::homePath() ).toString();
+
+    directory_path = QFileDialog::getExistingDirectory(this, tr("Export frames to..."),
+                                                       directory_path);
+    if( directory_path.isEmpty() )
+    {
+        return;
+    }
+    settings.setValue("SidepanelReplay.lastExportDirectory", directory_path);
+    settings.sync();
+
+    ui->pushButtonPlay->setChecked(false);
+
+    const int frames_count = _timepoint.size();
+    QProgressDialog progress("Exporting frames...", "Abort", 0, frames_count, this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+
+    QDir directory( directory_path );
+    ReplayExporter exporter( container );
+
+    for (int frame = 0; frame < frames_count && !progress.wasCanceled(); frame++)
+    {
+        const int row = _timepoint[frame].second;
+        exporter.setNodesStatus( _decoder.statusAt(row) );
+
+        const QString filename = QString("frame_%1.png").arg(frame, 6, 10, QChar('0'));
+        exporter.saveFrame( directory.absoluteFilePath(filename) );
+
+        if( frame % 16 == 0 ){
+            progress.setValue(frame);
+        }
+    }
+    const bool success = exporter.finish();
+    progress.setValue(frames_count);
+
+    // restore the status of the current row, through the same path
+    const int current_row = std::max(0, _prev_row);
+    exporter.setNodesStatus( _decoder.statusAt(current_row) );
+    container->flushStyleUpdates();
+    _prev_row = -1;
+    onRowChanged( current_row );
+
+    if( !success )
+    {
+        QMessageBox::warning( this, "Export failed",
+                              "Some of the frames could not be written in " + directory_path );
+    }
+}
+
+void SidepanelReplay::onTimeSelected(double timestamp)
+{
+    if( _transitions.empty() || ui->pushButtonPlay->isChecked() )
+    {
+        return;
+    }
+    // last transition that happened at or before the selected time
+    auto it = std::upper_bound( _transitions.begin(), _transitions.end(), timestamp,
+                                [](double value, const Transition& trans)
+    {
+        return value < trans.timestamp;
+    });
+    const int row = std::max( 0, int(it - _transitions.begin()) - 1 );
+
+    onRowChanged( row );
+    updatedSpinAndSlider( row );
+    ui->tableView->scrollTo( _table_model->index(row,0), QAbstractItemView::PositionAtCenter );
+}
+
 void SidepanelReplay::on_lineEditFilter_textChanged(const QString &filter_text)
 {
     for (int row=0; row < _table_model->rowCount(); row++ )
@@ -505,3 +1056,174 @@ void SidepanelReplay::on_lineEditFilter_textChanged(const QString &filter_text)
         }
     }
 }
+
+void SidepanelReplay::on_pushButtonCompare_clicked()
+{
+    if( _transitions.empty() )
+    {
+        return;
+    }
+    QSettings settings;
+    QString directory_path  = settings.value("SidepanelReplay.lastLoadDirectory",
+                                             QDir::homePath() ).toString();
+
+    QString fileName = QFileDialog::getOpenFileName(this,
+                                                    tr("Compare with log"), directory_path,
+                                                    tr("Flatbuffers log (*.fbl)"));
+    if (fileName.isEmpty() || !QFileInfo::exists(fileName))
+    {
+        return;
+    }
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)){
+        return;
+    }
+    loadComparisonLog( file.readAll(), QFileInfo(fileName).fileName() );
+}
+
+bool SidepanelReplay::loadComparisonLog(const QByteArray &content, const QString& name)
+{
+    const char* buffer = content.data();
+    const size_t read_bytes = content.size();
+
+    size_t bt_header_size = 0;
+    if( read_bytes >= 4 )
+    {
+        bt_header_size = flatbuffers::ReadScalar<uint32_t>(buffer);
+    }
+
+    // Only logs of the very same tree can be compared: the status of each node
+    // is shown on a copy of the scene already loaded.
+    const bool valid_header = bt_header_size > 0 && bt_header_size <= read_bytes - 4;
+    if( !valid_header || _tree_view.empty() ||
+        QByteArray::fromRawData( buffer+4, int(bt_header_size) ) != _tree_view.buffer() )
+    {
+        QMessageBox::warning( this, "Can't compare these logs",
+                              "The two logs must be recorded from the same tree");
+        return false;
+    }
+
+    _compare_transitions.clear();
+    const size_t records_offset = 4 + bt_header_size;
+    const DecodeResult result = decodeTransitions( &buffer[records_offset],
+                                                   read_bytes - records_offset,
+                                                   _tree_view.uidLookup(), &_compare_transitions );
+    UpdateRestartPoints( _loaded_tree.nodesCount(), _compare_transitions );
+
+    if( result.skipped_records > 0 || result.trailing_bytes > 0 )
+    {
+        reportCorruptRegions( result );
+    }
+    if( _compare_transitions.empty() )
+    {
+        closeComparison();
+        return false;
+    }
+
+    _compare_decoder.build( _loaded_tree.nodesCount(), _compare_transitions );
+    _compare_restart_rows.clear();
+    for (size_t row = 0; row < _compare_transitions.size(); row++)
+    {
+        if( _compare_transitions[row].is_tree_restart ){
+            _compare_restart_rows.push_back( row );
+        }
+    }
+
+    ui->comboBoxAlignment->setHidden( false );
+    ui->pushButtonCloseCompare->setHidden( false );
+
+    emit loadComparisonTree( _loaded_tree, name );
+
+    _compare_row = -1;
+    updateComparison( std::max(0, _prev_row) );
+    return true;
+}
+
+void SidepanelReplay::closeComparison()
+{
+    const bool was_open = !_compare_transitions.empty();
+
+    _compare_transitions.clear();
+    _compare_decoder.clear();
+    _compare_restart_rows.clear();
+    _compare_row = -1;
+
+    ui->comboBoxAlignment->setHidden( true );
+    ui->pushButtonCloseCompare->setHidden( true );
+
+    if( was_open )
+    {
+        emit comparisonClosed();
+    }
+}
+
+void SidepanelReplay::on_pushButtonCloseCompare_clicked()
+{
+    closeComparison();
+}
+
+void SidepanelReplay::on_comboBoxAlignment_currentIndexChanged(int)
+{
+    _compare_row = -1;
+    updateComparison( std::max(0, _prev_row) );
+}
+
+int SidepanelReplay::comparisonRow(int row, Alignment alignment) const
+{
+    const auto& current = _transitions;
+    const auto& other = _compare_transitions;
+
+    if( other.empty() || row < 0 || row >= int(current.size()) )
+    {
+        return -1;
+    }
+
+    // by default, same offset from the beginning of each log
+    double target_offset = current[row].timestamp - current.front().timestamp;
+    int first_row = 0;
+    int last_row = other.size() - 1;
+
+    if( alignment == ALIGN_BY_EXECUTION && !_restart_rows.empty() &&
+        !_compare_restart_rows.empty() && row >= _restart_rows.front() )
+    {
+        // same offset from the beginning of the same execution
+        const size_t execution = std::upper_bound( _restart_rows.begin(),
+                                                   _restart_rows.end(), row )
+                                 - _restart_rows.begin() - 1;
+
+        if( execution >= _compare_restart_rows.size() )
+        {
+            // the other log has fewer executions: show its end
+            return last_row;
+        }
+        first_row = _compare_restart_rows[execution];
+        if( execution + 1 < _compare_restart_rows.size() )
+        {
+            last_row = _compare_restart_rows[execution + 1] - 1;
+        }
+        target_offset = current[row].timestamp - current[ _restart_rows[execution] ].timestamp;
+    }
+
+    // last transition that happened at or before the same offset
+    const double other_origin = other[first_row].timestamp;
+    auto it = std::upper_bound( other.begin() + first_row, other.begin() + last_row + 1,
+                                target_offset,
+                                [other_origin](double value, const Transition& trans)
+    {
+        return value < trans.timestamp - other_origin;
+    });
+    return std::max( first_row, int(it - other.begin()) - 1 );
+}
+
+void SidepanelReplay::updateComparison(int row)
+{
+    const auto alignment = static_cast<Alignment>( ui->comboBoxAlignment->currentIndex() );
+    const int compare_row = comparisonRow( row, alignment );
+
+    if( compare_row < 0 || compare_row == _compare_row )
+    {
+        return;
+    }
+    _compare_row = compare_row;
+    emit changeComparisonNodeStyle( _compare_decoder.sequenceAt(compare_row) );
+}
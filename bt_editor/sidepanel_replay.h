@@ -6,6 +6,12 @@
 #include <QTableWidgetItem>
 #include <QStandardItemModel>
 #include "bt_editor_base.h"
+#include "replay_timeline.h"
+#include "flatbuffer_tree_view.h"
+
+class ReplayGanttWidget;
+class ReplayFlameGraphWidget;
+class QTabWidget;
 
 
 namespace Ui {
@@ -24,8 +30,29 @@ public:
 
     void loadLog(const QByteArray& content);
 
+    // Open many logs as a single session. The files sharing the same tree
+    // header are replayed as one timeline, one file after the other;
+    // selecting a file of another tree loads that tree and its timeline.
+    void loadSession(const QStringList& files);
+
+    size_t sessionFilesCount() const { return _session_files.size(); }
+
     size_t transitionsCount() const { return _transitions.size(); }
 
+    const std::vector<ReplayTransition>& transitions() const { return _transitions; }
+
+    // Replay a second log of the same tree in lock-step with the current one
+    bool loadComparisonLog(const QByteArray& content, const QString& name);
+
+    void closeComparison();
+
+    size_t comparisonTransitionsCount() const { return _compare_transitions.size(); }
+
+    enum Alignment{ ALIGN_BY_TIME = 0, ALIGN_BY_EXECUTION = 1 };
+
+    // Row of the compared log that corresponds to a row of the current one
+    int comparisonRow(int row, Alignment alignment) const;
+
 public slots:
 
     void on_LoadLog();
@@ -46,6 +73,20 @@ private slots:
 
     void on_lineEditFilter_textChanged(const QString &filter_text);
 
+    void on_pushButtonLoadSession_clicked();
+
+    void on_comboBoxLogFile_currentIndexChanged(int index);
+
+    void on_pushButtonTimeline_clicked();
+
+    void on_pushButtonExport_clicked();
+
+    void on_pushButtonCompare_clicked();
+
+    void on_pushButtonCloseCompare_clicked();
+
+    void on_comboBoxAlignment_currentIndexChanged(int index);
+
 signals:
     void loadBehaviorTree(const AbsBehaviorTree& tree, const QString& name );
 
@@ -54,6 +95,12 @@ signals:
 
     void addNewModel(const NodeModel &new_model);
 
+    void loadComparisonTree(const AbsBehaviorTree& tree, const QString& name);
+
+    void changeComparisonNodeStyle(const std::vector<std::pair<int, NodeStatus>>& node_status);
+
+    void comparisonClosed();
+
 private:
 
     bool eventFilter(QObject *object, QEvent *event) override;
@@ -62,17 +109,74 @@ private:
 
     void onRowChanged(int value);
 
+    void updateComparison(int row);
+
     Ui::SidepanelReplay *ui;
 
-    struct Transition{
-        int16_t index;
-        double timestamp;
-        NodeStatus prev_status;
-        NodeStatus status;
-        bool is_tree_restart;
-        int nearest_restart_transition_index;
-    };
+    typedef ReplayTransition Transition;
     std::vector<Transition> _transitions;
+
+    ReplayTimeline _timeline;
+
+    ReplayDecoder _decoder;
+
+    QTabWidget* _timeline_window;
+
+    ReplayGanttWidget* _gantt_widget;
+
+    ReplayFlameGraphWidget* _flamegraph_widget;
+
+    void updateTimeline();
+
+    void onTimeSelected(double timestamp);
+
+    struct DecodeResult{
+        size_t skipped_records = 0;
+        size_t trailing_bytes = 0;
+        std::vector<std::pair<long,long>> corrupt_regions;
+    };
+
+    DecodeResult decodeTransitions(const char* buffer, size_t size,
+                                   const std::vector<int32_t>& uid_lookup,
+                                   std::vector<Transition>* transitions);
+
+    bool loadHeader(const char* buffer, size_t read_bytes, size_t* header_size);
+
+    struct LogFile{
+        QString path;
+        uint header_hash;
+        size_t records_count;
+        double first_timestamp;
+        double last_timestamp;
+        // added to the timestamps of the file, on the timeline of its tree
+        double offset;
+        // first row of the file in _transitions, -1 if not loaded
+        int first_row;
+    };
+
+    bool scanLogFile(const QString& path, LogFile* log_file);
+
+    // Load the timeline of the file, if needed, and move to its first row
+    bool loadSessionFile(int file_index);
+
+    bool loadSessionTimeline(uint header_hash);
+
+    std::vector<LogFile> _session_files;
+    int _current_file;
+    double _timeline_origin;
+
+    // the header of the loaded log
+    FlatbufferTreeView _tree_view;
+    uint _loaded_header_hash;
+
+    void reportCorruptRegions(const DecodeResult& result);
+
+    std::vector<Transition> _compare_transitions;
+    ReplayDecoder _compare_decoder;
+    // rows where each execution of the tree starts
+    std::vector<int> _restart_rows;
+    std::vector<int> _compare_restart_rows;
+    int _compare_row;
     std::vector< std::pair<double,int>> _timepoint;
 
     int _prev_row;
@@ -0,0 +1,215 @@
+#include "undo_history.h"
+
+QByteArray UndoSnapshot::Tab::toBinary() const
+{
+    std::vector<QByteArray> nodes_data;
+    nodes_data.reserve( nodes.size() );
+    for (const auto& it: nodes)
+    {
+        nodes_data.push_back( it.second );
+    }
+    return QtNodes::FlowScene::joinNodesToBinary( layout, nodes_data );
+}
+
+std::set<QString> UndoCommand::changedTabs() const
+{
+    std::set<QString> names;
+    for (const auto& tab: tabs)
+    {
+        names.insert( tab.name );
+    }
+    for (const auto& node: nodes)
+    {
+        names.insert( node.tab );
+    }
+    return names;
+}
+
+UndoHistory::UndoHistory():
+    _merge_interval(500)
+{
+}
+
+void UndoHistory::reset(UndoSnapshot snapshot)
+{
+    _current = std::move(snapshot);
+    clearStacks();
+}
+
+void UndoHistory::clearStacks()
+{
+    _undo_stack.clear();
+    _redo_stack.clear();
+    _last_push.invalidate();
+}
+
+bool UndoHistory::push(const UndoChanges &changes)
+{
+    UndoCommand command;
+    command.view_before = _current.view;
+    command.view_after  = changes.view;
+
+    for (const auto& it: _current.tabs)
+    {
+        if( changes.tabs.count( it.first ) == 0 )
+        {
+            const auto& tab = it.second;
+            command.tabs.push_back( {it.first, true, false, tab.layout, tab.layout} );
+            for (const auto& node_it: tab.nodes)
+            {
+                command.nodes.push_back( {it.first, node_it.first, node_it.second, QByteArray()} );
+            }
+        }
+    }
+
+    static const std::map<QUuid, QByteArray> no_nodes;
+
+    for (const auto& it: changes.tabs)
+    {
+        const QString& name = it.first;
+        const auto& tab_changes = it.second;
+
+        const auto prev_tab = _current.tabs.find( name );
+        const bool existed = ( prev_tab != _current.tabs.end() );
+        const auto& prev_nodes = existed ? prev_tab->second.nodes : no_nodes;
+
+        if( !existed || prev_tab->second.layout != tab_changes.layout )
+        {
+            command.tabs.push_back( {name, existed, true,
+                                     existed ? prev_tab->second.layout : tab_changes.layout,
+                                     tab_changes.layout} );
+        }
+
+        if( tab_changes.complete )
+        {
+            for (const auto& node_it: prev_nodes)
+            {
+                if( tab_changes.nodes.count( node_it.first ) == 0 )
+                {
+                    command.nodes.push_back( {name, node_it.first, node_it.second, QByteArray()} );
+                }
+            }
+        }
+
+        for (const auto& node_it: tab_changes.nodes)
+        {
+            const auto prev = prev_nodes.find( node_it.first );
+            const QByteArray before = ( prev != prev_nodes.end() ) ? prev->second : QByteArray();
+            if( before != node_it.second )
+            {
+                command.nodes.push_back( {name, node_it.first, before, node_it.second} );
+            }
+        }
+    }
+
+    if( command.empty() )
+    {
+        _current.view = changes.view;
+        return false;
+    }
+
+    apply( command, true );
+    if( !tryMerge( command ) )
+    {
+        _undo_stack.push_back( std::move(command) );
+    }
+    _redo_stack.clear();
+    _last_push.start();
+    return true;
+}
+
+const UndoCommand *UndoHistory::undo()
+{
+    if( _undo_stack.empty() )
+    {
+        return nullptr;
+    }
+    _redo_stack.push_back( std::move(_undo_stack.back()) );
+    _undo_stack.pop_back();
+    _last_push.invalidate();
+
+    apply( _redo_stack.back(), false );
+    return &_redo_stack.back();
+}
+
+const UndoCommand *UndoHistory::redo()
+{
+    if( _redo_stack.empty() )
+    {
+        return nullptr;
+    }
+    _undo_stack.push_back( std::move(_redo_stack.back()) );
+    _redo_stack.pop_back();
+    _last_push.invalidate();
+
+    apply( _undo_stack.back(), true );
+    return &_undo_stack.back();
+}
+
+void UndoHistory::apply(const UndoCommand &command, bool forward)
+{
+    for (const auto& tab: command.tabs)
+    {
+        if( forward ? tab.existed_after : tab.existed_before )
+        {
+            _current.tabs[tab.name].layout = forward ? tab.layout_after : tab.layout_before;
+        }
+    }
+
+    for (const auto& change: command.nodes)
+    {
+        const QByteArray& state = forward ? change.after : change.before;
+        auto& nodes = _current.tabs[change.tab].nodes;
+        if( state.isEmpty() )
+        {
+            nodes.erase( change.id );
+        }
+        else{
+            nodes[change.id] = state;
+        }
+    }
+
+    for (const auto& tab: command.tabs)
+    {
+        if( !(forward ? tab.existed_after : tab.existed_before) )
+        {
+            _current.tabs.erase( tab.name );
+        }
+    }
+    _current.view = forward ? command.view_after : command.view_before;
+}
+
+bool UndoHistory::tryMerge(const UndoCommand &command)
+{
+    if( _merge_interval <= 0 || _undo_stack.empty() ||
+        !_last_push.isValid() || _last_push.elapsed() > _merge_interval )
+    {
+        return false;
+    }
+
+    UndoCommand& last = _undo_stack.back();
+    if( !last.tabs.empty() || !command.tabs.empty() ||
+        last.nodes.size() != 1 || command.nodes.size() != 1 )
+    {
+        return false;
+    }
+
+    // only a node modified twice, neither created nor removed
+    auto& last_change = last.nodes.front();
+    const auto& change = command.nodes.front();
+    if( last_change.tab != change.tab || last_change.id != change.id ||
+        last_change.before.isEmpty() || change.before.isEmpty() ||
+        change.after.isEmpty() )
+    {
+        return false;
+    }
+
+    last_change.after = change.after;
+    last.view_after = command.view_after;
+
+    if( last_change.before == last_change.after )
+    {
+        _undo_stack.pop_back();
+    }
+    return true;
+}
@@ -0,0 +1,142 @@
+#ifndef UNDO_HISTORY_H
+#define UNDO_HISTORY_H
+
+#include <map>
+#include <set>
+#include <deque>
+#include <vector>
+#include <QString>
+#include <QUuid>
+#include <QRectF>
+#include <QTransform>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <nodes/FlowScene>
+
+// What the user was looking at
+struct UndoView
+{
+    QString main_tree;
+    QString current_tab_name;
+    QTransform view_transform;
+    QRectF view_area;
+};
+
+// The whole document, as known by the undo history.
+// The state of each node is the output of FlowScene::saveNodeToBinary(),
+// that includes the connections of its input ports: a new or removed
+// connection is a change of the node it enters. The encoding is
+// deterministic, therefore two states can be compared byte by byte.
+struct UndoSnapshot
+{
+    struct Tab
+    {
+        QtNodes::PortLayout layout = QtNodes::PortLayout::Vertical;
+        std::map<QUuid, QByteArray> nodes;
+
+        // Same format of FlowScene::saveToBinary()
+        QByteArray toBinary() const;
+    };
+    UndoView view;
+    std::map<QString, Tab> tabs;
+};
+
+// The nodes that might have changed since the previous push
+struct UndoChanges
+{
+    struct Tab
+    {
+        QtNodes::PortLayout layout = QtNodes::PortLayout::Vertical;
+        // if true, the nodes of this tab that are not listed were removed
+        bool complete = false;
+        // an empty state means that the node was removed
+        std::map<QUuid, QByteArray> nodes;
+    };
+    UndoView view;
+    // all the tabs of the document: the missing ones were removed
+    std::map<QString, Tab> tabs;
+};
+
+// A reversible change: the state of the nodes it modified, before and after.
+// An empty state means that the node doesn't exist.
+struct UndoCommand
+{
+    struct NodeChange
+    {
+        QString tab;
+        QUuid id;
+        QByteArray before;
+        QByteArray after;
+    };
+
+    struct TabChange
+    {
+        QString name;
+        bool existed_before;
+        bool existed_after;
+        QtNodes::PortLayout layout_before;
+        QtNodes::PortLayout layout_after;
+    };
+
+    std::vector<TabChange> tabs;
+    std::vector<NodeChange> nodes;
+    UndoView view_before;
+    UndoView view_after;
+
+    bool empty() const { return tabs.empty() && nodes.empty(); }
+
+    std::set<QString> changedTabs() const;
+};
+
+/// Undo and redo stacks of UndoCommands.
+///
+/// Only the snapshot of the current state is complete; each command stores
+/// the nodes it changed, therefore the memory used by the stacks and the
+/// cost of push, undo and redo depend on the size of the changes, not on
+/// the size of the document.
+class UndoHistory
+{
+public:
+
+    UndoHistory();
+
+    // Forget all the commands and start from the given state
+    void reset(UndoSnapshot snapshot = UndoSnapshot());
+
+    void clearStacks();
+
+    const UndoSnapshot& current() const { return _current; }
+
+    // Consecutive changes of the same node, pushed within this interval,
+    // are merged into a single command (e.g. a node being dragged).
+    // Zero disables the merging.
+    void setMergeInterval(int msec) { _merge_interval = msec; }
+
+    // Return false if nothing changed, other than the view
+    bool push(const UndoChanges& changes);
+
+    // The command undone/redone, or nullptr if the stack is empty.
+    // The current snapshot is updated; the caller updates the scenes.
+    // The pointer is valid until the next change of the history.
+    const UndoCommand* undo();
+
+    const UndoCommand* redo();
+
+    size_t undoSize() const { return _undo_stack.size(); }
+
+    size_t redoSize() const { return _redo_stack.size(); }
+
+private:
+
+    void apply(const UndoCommand& command, bool forward);
+
+    bool tryMerge(const UndoCommand& command);
+
+    UndoSnapshot _current;
+    std::deque<UndoCommand> _undo_stack;
+    std::deque<UndoCommand> _redo_stack;
+    QElapsedTimer _last_push;
+    int _merge_interval;
+};
+
+#endif // UNDO_HISTORY_H
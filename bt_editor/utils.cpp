@@ -16,47 +16,14 @@ using QtNodes::FlowScene;
 
 QtNodes::Node* findRoot(const QtNodes::FlowScene &scene)
 {
-    Node* root = nullptr;
-
-    for (auto& it: scene.nodes() )
-    {
-        Node* node = it.second.get();
-        if( node->nodeDataModel()->nPorts( PortType::In ) == 0 )
-        {
-            if( !root ) root = node;
-            else return nullptr;
-        }
-        else if( node->nodeState().connections( PortType::In, 0 ).empty() )
-        {
-            if( !root ) root = node;
-            else return nullptr;
-        }
-    }
-    return root;
+    return scene.rootNode();
 }
 
 std::vector<Node*> getChildren(const QtNodes::FlowScene &scene,
                                const Node& parent_node,
                                bool ordered)
 {
-    std::vector<Node*> children;
-
-    if( parent_node.nodeDataModel()->nPorts(PortType::Out) == 0)
-    {
-        return children;
-    }
-
-    const auto& conn_out = parent_node.nodeState().connections(PortType::Out, 0);
-    children.reserve( conn_out.size() );
-
-    for( auto& it: conn_out)
-    {
-        auto child_node = it.second->getNode(PortType::In);
-        if( child_node )
-        {
-            children.push_back( child_node );
-        }
-    }
+    std::vector<Node*> children = scene.childNodes( parent_node );
 
     if( ordered && children.size() > 1)
     {
@@ -289,7 +256,7 @@ AbsBehaviorTree BuildTreeFromScene(const QtNodes::FlowScene *scene,
 
         auto bt_model = dynamic_cast<BehaviorTreeDataModel*>(node->nodeDataModel());
 
-        abs_node.model = bt_model->model();
+        abs_node.model = bt_model->modelPtr();
         abs_node.instance_name = bt_model->instanceName();
         abs_node.pos  = scene->getNodePosition(*node) ;
         abs_node.size = scene->getNodeSize(*node);
@@ -320,6 +287,9 @@ AbsBehaviorTree BuildTreeFromXML(const QDomElement& bt_root, const NodeModels& m
         throw std::runtime_error( "Expecting a node called <BehaviorTree>");
     }
 
+    // a single copy of each model, shared by all the nodes using it
+    std::map<QString, NodeModelPtr> shared_models;
+
     //-------------------------------------
     std::function<void(AbstractTreeNode* parent, QDomElement)> recursiveStep;
     recursiveStep = [&](AbstractTreeNode* parent, QDomElement xml_node)
@@ -342,7 +312,12 @@ AbsBehaviorTree BuildTreeFromXML(const QDomElement& bt_root, const NodeModels& m
         {
              throw std::runtime_error( (QString("This model has not been registered: ") + modelID).toStdString() );
         }
-        tree_node.model = model_it->second;
+        NodeModelPtr& shared_model = shared_models[modelID];
+        if( !shared_model )
+        {
+            shared_model = std::make_shared<const NodeModel>( model_it->second );
+        }
+        tree_node.model = shared_model;
 
         if( xml_node.hasAttribute("name") )
         {
@@ -398,76 +373,6 @@ AbsBehaviorTree BuildTreeFromXML(const QDomElement& bt_root, const NodeModels& m
 }
 
 
-std::pair<AbsBehaviorTree, std::unordered_map<int, int>>
-BuildTreeFromFlatbuffers(const Serialization::BehaviorTree *fb_behavior_tree)
-{
-    AbsBehaviorTree tree;
-    std::unordered_map<int, int> uid_to_index;
-
-    AbstractTreeNode abs_root;
-    abs_root.instance_name = "Root";
-    abs_root.model.registration_ID = "Root";
-    abs_root.model.registration_ID = "Root";
-    abs_root.children_index.push_back( 1 );
-
-    tree.addNode( nullptr, std::move(abs_root) );
-
-    //-----------------------------------------
-    NodeModels models;
-
-    for( const Serialization::NodeModel* model_node: *(fb_behavior_tree->node_models()) )
-    {
-        NodeModel model;
-        model.registration_ID = model_node->registration_name()->c_str();
-        model.type = convert( model_node->type() );
-
-        for( const Serialization::PortModel* port: *(model_node->ports()) )
-        {
-            PortModel port_model;
-            QString port_name = port->port_name()->c_str();
-            port_model.direction = convert( port->direction() );
-            port_model.type_name = port->type_info()->c_str();
-            port_model.description = port->description()->c_str();
-
-            model.ports.insert( { port_name, std::move(port_model) } );
-        }
-
-        models.insert( { model.registration_ID, std::move(model)} );
-    }
-
-    //-----------------------------------------
-    for( const Serialization::TreeNode* fb_node: *(fb_behavior_tree->nodes()) )
-    {
-        AbstractTreeNode abs_node;
-        abs_node.instance_name = fb_node->instance_name()->c_str();
-        const char* registration_ID = fb_node->registration_name()->c_str();
-        abs_node.status = convert( fb_node->status() );
-        abs_node.model = (models.at(registration_ID));
-
-        for( const Serialization::PortConfig* pair: *(fb_node->port_remaps()) )
-        {
-            abs_node.ports_mapping.insert( { QString(pair->port_name()->c_str()),
-                                             QString(pair->remap()->c_str()) } );
-        }
-        int index = tree.nodesCount();
-        abs_node.index = index;
-        tree.nodes().push_back( std::move(abs_node) );
-        uid_to_index.insert( { fb_node->uid(), index} );
-    }
-
-    for(size_t index = 0; index < fb_behavior_tree->nodes()->size(); index++ )
-    {
-        const Serialization::TreeNode* fb_node = fb_behavior_tree->nodes()->Get(index);
-        AbstractTreeNode* abs_node = tree.node( index + 1);
-        for( const auto child_uid: *(fb_node->children_uid()) )
-        {
-            int child_index = uid_to_index[ child_uid ];
-            abs_node->children_index.push_back(child_index);
-        }
-    }
-    return { tree, uid_to_index };
-}
-
 std::pair<QtNodes::NodeStyle, QtNodes::ConnectionStyle>
 getStyleFromStatus(NodeStatus status, NodeStatus prev_status)
 {
@@ -535,17 +440,43 @@ getStyleFromStatus(NodeStatus status, NodeStatus prev_status)
     return {node_style, conn_style};
 }
 
-QtNodes::Node *GetParentNode(QtNodes::Node *node)
+std::vector<std::pair<NodeStatus, NodeStatus>>
+ResolveNodesStatus(size_t nodes_count,
+                   const std::vector<std::pair<int, NodeStatus>>& node_status)
 {
-    using namespace QtNodes;
-    auto conn_in = node->nodeState().connections(PortType::In, 0);
-    if( conn_in.size() == 0)
+    std::vector<std::pair<NodeStatus, NodeStatus>> result( nodes_count,
+                                                           { NodeStatus::IDLE, NodeStatus::IDLE } );
+    std::vector<NodeStatus> last_status( nodes_count, NodeStatus::IDLE );
+    // position in the sequence of the last change of each node
+    std::vector<int> last_change( nodes_count, -1 );
+    int last_reset = -1;
+
+    for (int i = 0; i < int(node_status.size()); i++)
     {
-        return nullptr;
+        const int index = node_status[i].first;
+        const NodeStatus status = node_status[i].second;
+        if( index < 0 || index >= int(nodes_count) )
+        {
+            continue;
+        }
+        // the root becoming RUNNING resets the style of the entire tree
+        if( index == 1 && status == NodeStatus::RUNNING )
+        {
+            last_reset = i;
+        }
+        result[index] = { status, last_status[index] };
+        last_status[index] = status;
+        last_change[index] = i;
     }
-    else{
-        return conn_in.begin()->second->getNode(PortType::Out);
+
+    for (size_t index = 0; index < nodes_count; index++)
+    {
+        if( last_change[index] < last_reset )
+        {
+            result[index] = { NodeStatus::IDLE, NodeStatus::IDLE };
+        }
     }
+    return result;
 }
 
 std::vector<QString> GetModelsToRemove(QWidget* parent,
@@ -19,9 +19,6 @@ std::vector<QtNodes::Node *> getChildren(const QtNodes::FlowScene &scene,
 AbsBehaviorTree BuildTreeFromScene(const QtNodes::FlowScene *scene,
                                    QtNodes::Node *root_node = nullptr);
 
-std::pair<AbsBehaviorTree, std::unordered_map<int, int> >
-BuildTreeFromFlatbuffers(const Serialization::BehaviorTree* bt );
-
 AbsBehaviorTree BuildTreeFromXML(const QDomElement &bt_root, const NodeModels &models);
 
 void NodeReorder(QtNodes::FlowScene &scene, AbsBehaviorTree &abstract_tree );
@@ -29,7 +26,12 @@ void NodeReorder(QtNodes::FlowScene &scene, AbsBehaviorTree &abstract_tree );
 std::pair<QtNodes::NodeStyle, QtNodes::ConnectionStyle>
 getStyleFromStatus(NodeStatus status, NodeStatus prev_status);
 
-QtNodes::Node* GetParentNode(QtNodes::Node* node);
+// Status shown by each node after applying a sequence of status changes,
+// with the same rules of MainWindow::onChangeNodesStatus. The result contains,
+// for each node, the pair of arguments to be passed to getStyleFromStatus().
+std::vector<std::pair<NodeStatus, NodeStatus>>
+ResolveNodesStatus(size_t nodes_count,
+                   const std::vector<std::pair<int, NodeStatus>>& node_status);
 
 std::vector<QString> GetModelsToRemove(QWidget* parent,
                                        NodeModels& prev_models,
@@ -0,0 +1,322 @@
+#include "groot_test_base.h"
+#include <QFile>
+#include <QImage>
+#include <QPainter>
+#include <QOpenGLWidget>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <set>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+class BenchmarkTest : public GrootTestBase
+{
+    Q_OBJECT
+
+public:
+    BenchmarkTest() {}
+    ~BenchmarkTest() {}
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void largeTreeMemory();
+    void saveScene_data();
+    void saveScene();
+    void loadScene_data();
+    void loadScene();
+    void loadTreeXML();
+    void copyLargeTree();
+    void paintScene();
+    void viewFrameTime_data();
+    void viewFrameTime();
+
+private:
+    // A tree made of builtin nodes only, with about nodes_count nodes
+    static QString largeTreeXML(int nodes_count);
+
+    // Rows "json" and "binary", reported next to each other
+    static void sceneFormats();
+
+    // Resident memory of the process in bytes, 0 where it can't be read
+    static qint64 residentMemory();
+
+    AbsBehaviorTree _large_tree;
+};
+
+QString BenchmarkTest::largeTreeXML(int nodes_count)
+{
+    QString xml = "<root main_tree_to_execute=\"BehaviorTree\">"
+                  "<BehaviorTree ID=\"BehaviorTree\"><Sequence>";
+
+    for (int i = 0; i < nodes_count / 3; i++)
+    {
+        xml += QString("<Sequence name=\"step_%1\">"
+                       "<AlwaysSuccess/>"
+                       "<SetBlackboard value=\"%1\" output_key=\"key_%1\"/>"
+                       "</Sequence>").arg(i);
+    }
+    xml += "</Sequence></BehaviorTree></root>";
+    return xml;
+}
+
+void BenchmarkTest::initTestCase()
+{
+    main_win = new MainWindow(GraphicMode::EDITOR, nullptr);
+    main_win->resize(1200, 800);
+    main_win->show();
+
+    main_win->loadFromXML( largeTreeXML(3000) );
+    _large_tree = getAbstractTree();
+    QVERIFY( _large_tree.nodesCount() > 3000 );
+}
+
+void BenchmarkTest::cleanupTestCase()
+{
+    QApplication::processEvents();
+    main_win->on_actionClear_triggered();
+    main_win->close();
+}
+
+qint64 BenchmarkTest::residentMemory()
+{
+#ifdef Q_OS_LINUX
+    QFile statm("/proc/self/statm");
+    if( statm.open( QIODevice::ReadOnly ) )
+    {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if( fields.size() > 1 )
+        {
+            return fields[1].toLongLong() * sysconf( _SC_PAGESIZE );
+        }
+    }
+#endif
+    return 0;
+}
+
+void BenchmarkTest::largeTreeMemory()
+{
+    if( residentMemory() == 0 )
+    {
+        QSKIP("The resident memory can't be read on this platform");
+    }
+    // first after initTestCase(), the least memory freed and reused;
+    // still approximate, and by pages
+    const int copies_count = 50;
+    std::vector<AbsBehaviorTree> copies;
+    copies.reserve( copies_count );
+
+    const qint64 before = residentMemory();
+    for (int i = 0; i < copies_count; i++)
+    {
+        copies.push_back( _large_tree );
+    }
+    const qint64 after = residentMemory();
+
+    QVERIFY( copies.back() == _large_tree );
+    QTest::setBenchmarkResult( qreal(after - before) / copies_count, QTest::BytesAllocated );
+}
+
+void BenchmarkTest::sceneFormats()
+{
+    QTest::addColumn<bool>("binary");
+    QTest::newRow("json") << false;
+    QTest::newRow("binary") << true;
+}
+
+void BenchmarkTest::saveScene_data()
+{
+    sceneFormats();
+}
+
+void BenchmarkTest::saveScene()
+{
+    QFETCH(bool, binary);
+
+    auto scene = main_win->currentTabInfo()->scene();
+    QByteArray data;
+    if( binary )
+    {
+        QBENCHMARK {
+            data = scene->saveToBinary();
+        }
+        // deterministic: the same scene gives the same bytes
+        QVERIFY( scene->saveToBinary() == data );
+        QVERIFY( data.size() < scene->saveToMemory().size() );
+    }
+    else{
+        QBENCHMARK {
+            data = scene->saveToMemory();
+        }
+        QVERIFY( !data.isEmpty() );
+    }
+}
+
+void BenchmarkTest::loadScene_data()
+{
+    sceneFormats();
+}
+
+void BenchmarkTest::loadScene()
+{
+    QFETCH(bool, binary);
+
+    auto container = main_win->currentTabInfo();
+    if( binary )
+    {
+        const QByteArray data = container->scene()->saveToBinary();
+        QBENCHMARK {
+            container->loadFromBinary( data );
+        }
+    }
+    else{
+        const QByteArray data = container->scene()->saveToMemory();
+        QBENCHMARK {
+            container->loadFromJson( data );
+        }
+    }
+    QVERIFY( getAbstractTree() == _large_tree );
+}
+
+void BenchmarkTest::loadTreeXML()
+{
+    const QString xml = largeTreeXML(3000);
+    QBENCHMARK {
+        main_win->loadFromXML( xml );
+    }
+    QVERIFY( getAbstractTree() == _large_tree );
+}
+
+void BenchmarkTest::copyLargeTree()
+{
+    // one model for each registration ID, whatever the number of nodes
+    std::set<const NodeModel*> models;
+    std::set<QString> registration_IDs;
+    for (const auto& node: _large_tree.nodes())
+    {
+        models.insert( node.model.get() );
+        registration_IDs.insert( node.model->registration_ID );
+    }
+    QCOMPARE( models.size(), registration_IDs.size() );
+
+    AbsBehaviorTree copy;
+    QBENCHMARK {
+        copy = _large_tree;
+    }
+    QVERIFY( copy == _large_tree );
+}
+
+void BenchmarkTest::paintScene()
+{
+    auto scene = main_win->currentTabInfo()->scene();
+    const QRectF source = scene->itemsBoundingRect();
+
+    // every node painted, at full detail
+    QImage image( 2000, 2000, QImage::Format_ARGB32_Premultiplied );
+    QBENCHMARK {
+        image.fill( Qt::transparent );
+        QPainter painter( &image );
+        painter.setRenderHint( QPainter::Antialiasing );
+        scene->render( &painter, QRectF(), source );
+    }
+
+    // painting doesn't change the size of the nodes
+    for (const auto& it: scene->nodes())
+    {
+        QVERIFY( !it.second->nodeGeometry().isDirty() );
+    }
+    QVERIFY( getAbstractTree() == _large_tree );
+}
+
+void BenchmarkTest::viewFrameTime_data()
+{
+    QTest::addColumn<bool>("opengl");
+    QTest::addColumn<QString>("workload");
+
+    for (bool opengl: {false, true})
+    {
+        for (const char* workload: {"pan", "zoom", "status"})
+        {
+            QTest::newRow( QString("%1 %2").arg(opengl ? "opengl" : "raster")
+                           .arg(workload).toLatin1() ) << opengl << QString(workload);
+        }
+    }
+}
+
+void BenchmarkTest::viewFrameTime()
+{
+    QFETCH(bool, opengl);
+    QFETCH(QString, workload);
+
+    auto container = main_win->currentTabInfo();
+    auto view = container->view();
+
+    if( !view->setOpenGLViewport( opengl ) )
+    {
+        QSKIP("OpenGL is not available");
+    }
+    container->zoomHomeView();
+    view->scale( 4.0, 4.0 );
+    QApplication::processEvents();
+
+    if( opengl )
+    {
+        // in the log, to tell a GPU from Mesa's software rasterizer
+        auto gl_widget = qobject_cast<QOpenGLWidget*>( view->viewport() );
+        QVERIFY( gl_widget && gl_widget->context() );
+        gl_widget->makeCurrent();
+        const QByteArray renderer( reinterpret_cast<const char*>(
+            gl_widget->context()->functions()->glGetString( GL_RENDERER ) ) );
+        gl_widget->doneCurrent();
+        qInfo() << "OpenGL renderer:" << renderer;
+
+        // e.g. GALLIUM_DRIVER=llvmpipe, set by the llvmpipe variant of the test
+        const QByteArray driver = qgetenv( "GALLIUM_DRIVER" );
+        if( !driver.isEmpty() )
+        {
+            QVERIFY( renderer.contains( driver ) );
+        }
+    }
+
+    const QRectF area = container->scene()->itemsBoundingRect();
+    const int nodes_count = getAbstractTree().nodesCount();
+    int frame = 0;
+
+    // built once: only the update of the styles and the paint are measured
+    std::vector<std::pair<int, NodeStatus>> running_status;
+    std::vector<std::pair<int, NodeStatus>> success_status;
+    for (int i = 0; i < nodes_count; i++)
+    {
+        running_status.push_back( {i, NodeStatus::RUNNING} );
+        success_status.push_back( {i, NodeStatus::SUCCESS} );
+    }
+
+    QBENCHMARK {
+        frame++;
+        if( workload == "pan" )
+        {
+            view->centerOn( area.left() + area.width() * (frame % 10) / 10.0,
+                            area.center().y() );
+        }
+        else if( workload == "zoom" )
+        {
+            const double factor = (frame % 2) ? 1.25 : 0.8;
+            view->scale( factor, factor );
+        }
+        else{
+            main_win->onChangeNodesStatus( "BehaviorTree",
+                                           (frame % 2) ? running_status : success_status );
+            container->flushStyleUpdates();
+        }
+        view->viewport()->repaint();
+    }
+
+    QVERIFY( view->setOpenGLViewport( false ) );
+    QVERIFY( getAbstractTree() == _large_tree );
+}
+
+QTEST_MAIN(BenchmarkTest)
+
+#include "benchmark_test.moc"
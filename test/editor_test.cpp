@@ -2,6 +2,11 @@
 #include "bt_editor/sidepanel_editor.h"
 #include <QAction>
 #include <QLineEdit>
+#include <QGraphicsProxyWidget>
+#include <QTemporaryFile>
+#include "bt_editor/models/NodesStyle.hpp"
+#include <set>
+#include <stdexcept>
 
 class EditorTest : public GrootTestBase
 {
@@ -27,6 +32,22 @@ private slots:
     void longNames();
     void clearModels();
     void undoWithSubtreeExpanded();
+    void undoAfterCreateSubtree();
+    void sharedNodeModels();
+    void cachedLoadedTree();
+    void undoHistoryCommands();
+    void undoKeepsUnchangedNodes();
+    void sceneTopology();
+    void sceneBatch();
+    void treeContentHash();
+    void recycledNodeModels();
+    void nodesStyleCache();
+    void paintedNodes();
+    void detailLevels();
+    void virtualizedWidgets();
+    void editPaintedFields();
+    void coalescedStyleUpdates();
+    void openGLViewport();
 };
 
 
@@ -460,7 +481,7 @@ void EditorTest::modifyCustomModel()
     auto jump_abs_node = abs_tree.findFirstNode( jump_model.registration_ID );
     QVERIFY( jump_abs_node != nullptr);
     sleepAndRefresh( 500 );
-    QCOMPARE( jump_abs_node->model, jump_model );
+    QCOMPARE( *jump_abs_node->model, jump_model );
 
     sleepAndRefresh( 500 );
 }
@@ -560,12 +581,12 @@ void EditorTest::longNames()
     auto abs_tree = getAbstractTree();
     QCOMPARE( abs_tree.nodesCount(), size_t(4) );
     auto sequence = abs_tree.node(1);
-    QCOMPARE( sequence->model.registration_ID, QString("Sequence"));
+    QCOMPARE( sequence->model->registration_ID, QString("Sequence"));
 
     // second child on the right side.
     int short_index = sequence->children_index[1];
     auto short_node = abs_tree.node(short_index);
-    QCOMPARE( short_node->model.registration_ID, QString("short") );
+    QCOMPARE( short_node->model->registration_ID, QString("short") );
 }
 
 void EditorTest::clearModels()
@@ -633,6 +654,704 @@ void EditorTest::undoWithSubtreeExpanded()
      sleepAndRefresh( 500 );
 }
 
+void EditorTest::undoAfterCreateSubtree()
+{
+    QString file_xml = readFile(":/crossdoor_with_subtree.xml");
+    main_win->on_actionClear_triggered();
+    main_win->loadFromXML( file_xml );
+
+    auto main_tree = getAbstractTree("MainTree");
+    auto sequence_node = main_tree.findFirstNode("door_open_sequence")->graphic_node;
+    const size_t count_before = main_win->getTabByName("MainTree")->scene()->nodes().size();
+
+    // the sequence is replaced by the subtree, its two children removed
+    main_win->getTabByName("MainTree")->createSubtree( *sequence_node, "DoorOpen" );
+    sleepAndRefresh( 500 );
+
+    const size_t count_after = main_win->getTabByName("MainTree")->scene()->nodes().size();
+    QCOMPARE( count_after, count_before - 2 );
+
+    // a new layout reloads the whole tab from the undo history, where
+    // the removed nodes must not be found anymore
+    main_win->on_toolButtonLayout_clicked();
+    sleepAndRefresh( 500 );
+
+    main_win->onUndoInvoked();
+    QCOMPARE( main_win->getTabByName("MainTree")->scene()->nodes().size(), count_after );
+
+    main_win->onRedoInvoked();
+    QCOMPARE( main_win->getTabByName("MainTree")->scene()->nodes().size(), count_after );
+
+    main_win->on_toolButtonLayout_clicked();
+    sleepAndRefresh( 500 );
+}
+
+void EditorTest::sharedNodeModels()
+{
+    QString file_xml = readFile(":/test_xml_key_reordering_issue.xml");
+    main_win->on_actionClear_triggered();
+    main_win->loadFromXML( file_xml );
+
+    auto abs_tree = getAbstractTree("ExecutePath");
+    auto fallback = abs_tree.node(1);
+    QCOMPARE( fallback->children_index.size(), size_t(3) );
+
+    // nodes with the same registration ID share the same model
+    auto first_sequence = abs_tree.node( fallback->children_index[0] );
+    auto last_sequence  = abs_tree.node( fallback->children_index[2] );
+    QCOMPARE( first_sequence->model->registration_ID, QString("Sequence") );
+    QVERIFY( first_sequence->model == last_sequence->model );
+
+    // and so do the copies of the tree
+    AbsBehaviorTree tree_copy = abs_tree;
+    QVERIFY( tree_copy.node(1)->model == fallback->model );
+}
+
+void EditorTest::cachedLoadedTree()
+{
+    QString file_xml = readFile(":/test_xml_key_reordering_issue.xml");
+    main_win->on_actionClear_triggered();
+    main_win->loadFromXML( file_xml );
+
+    auto container = main_win->getTabByName("ExecutePath");
+    auto scene = container->scene();
+
+    const AbsBehaviorTree& tree = container->loadedTree();
+    QVERIFY( tree == BuildTreeFromScene( scene ) );
+
+    // nothing changed: the tree is not built again
+    const quint64 revision = scene->revision();
+    const quint64 topology = scene->topologyRevision();
+    QCOMPARE( &container->loadedTree(), &tree );
+    QCOMPARE( scene->revision(), revision );
+
+    // a change of the instance name is not seen by the scene, but it is by the tree
+    auto gui_node = tree.node(1)->graphic_node;
+    auto bt_model = dynamic_cast<BehaviorTreeDataModel*>( gui_node->nodeDataModel() );
+    bt_model->setInstanceName("RenamedFallback");
+    QVERIFY( scene->revision() != revision );
+    QCOMPARE( container->loadedTree().node(1)->instance_name, QString("RenamedFallback") );
+
+    // and so is a node being moved
+    const QPointF new_pos = scene->getNodePosition( *gui_node ) + QPointF(100, 50);
+    scene->setNodePosition( *gui_node, new_pos );
+    QCOMPARE( container->loadedTree().node(1)->pos, new_pos );
+    QVERIFY( container->loadedTree() == BuildTreeFromScene( scene ) );
+
+    // the touched nodes were updated, the scene has the same topology
+    QCOMPARE( scene->topologyRevision(), topology );
+    QCOMPARE( container->loadedTree().contentHash(), BuildTreeFromScene( scene ).contentHash() );
+
+    // swapping two children changes their order in the tree
+    const auto children = container->loadedTree().node(1)->children_index;
+    auto first_child = container->loadedTree().node( children.front() )->graphic_node;
+    auto last_child  = container->loadedTree().node( children.back() )->graphic_node;
+    const QPointF first_pos = scene->getNodePosition( *first_child );
+    scene->setNodePosition( *first_child, scene->getNodePosition( *last_child ) );
+    scene->setNodePosition( *last_child, first_pos );
+
+    const AbsBehaviorTree& reordered = container->loadedTree();
+    QCOMPARE( reordered.node( reordered.node(1)->children_index.front() )->graphic_node, last_child );
+    QVERIFY( reordered == BuildTreeFromScene( scene ) );
+}
+
+void EditorTest::undoHistoryCommands()
+{
+    // the history doesn't look into the states of the nodes
+    auto nodeState = [](const QString& alias) { return alias.toUtf8(); };
+    const QUuid id_A = QUuid::createUuid();
+    const QUuid id_B = QUuid::createUuid();
+
+    UndoHistory history;
+    history.setMergeInterval(0);
+
+    UndoChanges changes;
+    changes.tabs["MainTree"].complete = true;
+    changes.tabs["MainTree"].nodes[id_A] = nodeState("A");
+    changes.tabs["MainTree"].nodes[id_B] = nodeState("B");
+    QVERIFY( history.push(changes) );
+
+    // only B changed, A is not even listed
+    UndoChanges edit;
+    edit.tabs["MainTree"].nodes[id_B] = nodeState("B2");
+    QVERIFY( history.push(edit) );
+    QVERIFY( !history.push(edit) );
+    QCOMPARE( history.undoSize(), size_t(2) );
+
+    auto command = history.undo();
+    QVERIFY( command != nullptr );
+    QCOMPARE( command->nodes.size(), size_t(1) );
+    const auto& nodes = history.current().tabs.at("MainTree").nodes;
+    QVERIFY( nodes.at(id_A) == nodeState("A") );
+    QVERIFY( nodes.at(id_B) == nodeState("B") );
+
+    QVERIFY( history.redo() != nullptr );
+    QVERIFY( history.redo() == nullptr );
+    QVERIFY( history.current().tabs.at("MainTree").nodes.at(id_B) == nodeState("B2") );
+
+    // consecutive changes of the same node are merged
+    history.setMergeInterval(60000);
+    edit.tabs["MainTree"].nodes[id_B] = nodeState("B3");
+    QVERIFY( history.push(edit) );
+    edit.tabs["MainTree"].nodes[id_B] = nodeState("B4");
+    QVERIFY( history.push(edit) );
+    QCOMPARE( history.undoSize(), size_t(3) );
+    history.undo();
+    QVERIFY( history.current().tabs.at("MainTree").nodes.at(id_B) == nodeState("B2") );
+
+    // a removed tab takes its nodes with it
+    QVERIFY( history.push( UndoChanges() ) );
+    QVERIFY( history.current().tabs.empty() );
+    history.undo();
+    QCOMPARE( history.current().tabs.at("MainTree").nodes.size(), size_t(2) );
+}
+
+void EditorTest::undoKeepsUnchangedNodes()
+{
+    QString file_xml = readFile(":/show_all.xml");
+    main_win->on_actionClear_triggered();
+    main_win->loadFromXML( file_xml );
+
+    auto container = main_win->currentTabInfo();
+    auto view = container->view();
+    auto abs_tree = getAbstractTree();
+
+    auto pippo_node = abs_tree.findFirstNode("Pippo")->graphic_node;
+    auto first_node = abs_tree.node(1)->graphic_node;
+    QVERIFY( pippo_node != first_node );
+
+    auto pippo_model = dynamic_cast<BehaviorTreeDataModel*>( pippo_node->nodeDataModel() );
+    pippo_model->setInstanceName("Pluto");
+    QVERIFY( getAbstractTree().findFirstNode("Pippo") == nullptr );
+
+    main_win->onUndoInvoked();
+    sleepAndRefresh( 500 );
+
+    // same tab and view, and the nodes were patched, not created again
+    QCOMPARE( main_win->currentTabInfo(), container );
+    QCOMPARE( container->view(), view );
+
+    auto undo_tree = getAbstractTree();
+    QVERIFY( undo_tree == abs_tree );
+    QCOMPARE( undo_tree.findFirstNode("Pippo")->graphic_node, pippo_node );
+    QCOMPARE( undo_tree.node(1)->graphic_node, first_node );
+}
+
+void EditorTest::sceneTopology()
+{
+    QString file_xml = readFile(":/test_xml_key_reordering_issue.xml");
+    main_win->on_actionClear_triggered();
+    main_win->loadFromXML( file_xml );
+
+    auto container = main_win->getTabByName("ExecutePath");
+    auto scene = container->scene();
+    const AbsBehaviorTree tree = container->loadedTree();
+
+    QCOMPARE( scene->rootNode(), tree.rootNode()->graphic_node );
+    QVERIFY( scene->parentNode( *tree.rootNode()->graphic_node ) == nullptr );
+
+    for (const auto& abs_node: tree.nodes())
+    {
+        auto gui_node = abs_node.graphic_node;
+        QCOMPARE( scene->childNodes( *gui_node ).size(), abs_node.children_index.size() );
+        for (int index: abs_node.children_index)
+        {
+            QCOMPARE( scene->parentNode( *tree.node(index)->graphic_node ), gui_node );
+        }
+    }
+
+    // detach the first node after Root: two roots, thus none
+    auto child = tree.node( tree.rootNode()->children_index.front() )->graphic_node;
+    auto connection = child->nodeState().connections(QtNodes::PortType::In, 0).begin()->second;
+    scene->deleteConnection( *connection );
+
+    QVERIFY( scene->parentNode( *child ) == nullptr );
+    QVERIFY( scene->childNodes( *tree.rootNode()->graphic_node ).empty() );
+    QVERIFY( scene->rootNode() == nullptr );
+
+    // connect it again
+    scene->createConnection( *child, 0, *tree.rootNode()->graphic_node, 0 );
+    QCOMPARE( scene->parentNode( *child ), tree.rootNode()->graphic_node );
+    QCOMPARE( scene->rootNode(), tree.rootNode()->graphic_node );
+}
+
+void EditorTest::sceneBatch()
+{
+    main_win->on_actionClear_triggered();
+    auto scene = main_win->currentTabInfo()->scene();
+
+    int created = 0;
+    auto connection = connect( scene, &QtNodes::FlowScene::nodeCreated,
+                               [&created](QtNodes::Node&){ created++; } );
+    {
+        QtNodes::FlowSceneBatch batch( *scene );
+        scene->createNodeAtPos( "AlwaysSuccess", "first", QPointF(0,0) );
+        scene->createNodeAtPos( "AlwaysSuccess", "second", QPointF(0,100) );
+        QCOMPARE( created, 0 );
+        batch.commit();
+        QCOMPARE( created, 2 );
+    }
+    QCOMPARE( created, 2 );
+
+    // left without commit(), as by an exception: nothing announced
+    try {
+        QtNodes::FlowSceneBatch batch( *scene );
+        scene->createNodeAtPos( "AlwaysSuccess", "third", QPointF(0,200) );
+        throw std::runtime_error("load failed");
+    }
+    catch( std::runtime_error& ) {}
+
+    QCOMPARE( created, 2 );
+    QVERIFY( !scene->inBatch() );
+    disconnect( connection );
+    main_win->on_actionClear_triggered();
+}
+
+void EditorTest::treeContentHash()
+{
+    QString file_xml = readFile(":/crossdoor_with_subtree.xml");
+    main_win->on_actionClear_triggered();
+    main_win->loadFromXML( file_xml );
+
+    AbsBehaviorTree tree = getAbstractTree("MainTree");
+    AbsBehaviorTree copy = tree;
+    QVERIFY( tree.contentHash() != 0 );
+    QCOMPARE( copy.contentHash(), tree.contentHash() );
+
+    // a leaf and its parent change, the root changes too
+    const auto leaf_index = tree.nodesCount() - 1;
+    const uint64_t leaf_hash = tree.nodeHash( leaf_index );
+    copy.setInstanceName( leaf_index, "Renamed" );
+    QVERIFY( copy.nodeHash( leaf_index ) != leaf_hash );
+    QVERIFY( copy.contentHash() != tree.contentHash() );
+    QVERIFY( copy != tree );
+
+    // updated incrementally, as if computed from scratch
+    AbsBehaviorTree rehashed;
+    for (const auto& node: copy.nodes())
+    {
+        rehashed.nodes().push_back( node );
+    }
+    QCOMPARE( rehashed.contentHash(), copy.contentHash() );
+
+    copy.setInstanceName( leaf_index, tree.node( leaf_index )->instance_name );
+    QCOMPARE( copy.contentHash(), tree.contentHash() );
+
+    // position and status are not part of the structure
+    copy.node( leaf_index )->pos += QPointF( 10, 10 );
+    copy.node( leaf_index )->status = NodeStatus::RUNNING;
+    QCOMPARE( copy.contentHash(), tree.contentHash() );
+
+    // port mappings are
+    PortsMapping ports_mapping = copy.node( leaf_index )->ports_mapping;
+    ports_mapping["some_port"] = "{some_key}";
+    copy.setPortsMapping( leaf_index, ports_mapping );
+    QVERIFY( copy.contentHash() != tree.contentHash() );
+
+    // so is a new child
+    AbstractTreeNode new_leaf;
+    new_leaf.model = copy.node( leaf_index )->model;
+    copy.setPortsMapping( leaf_index, tree.node( leaf_index )->ports_mapping );
+    copy.addNode( copy.rootNode(), std::move(new_leaf) );
+    QVERIFY( copy.contentHash() != tree.contentHash() );
+}
+
+void EditorTest::recycledNodeModels()
+{
+    QString file_xml = readFile(":/crossdoor_with_subtree.xml");
+    main_win->on_actionClear_triggered();
+    main_win->loadFromXML( file_xml );
+
+    const AbsBehaviorTree first_tree = getAbstractTree();
+    std::set<QtNodes::NodeDataModel*> first_models;
+    for (const auto& node: first_tree.nodes())
+    {
+        first_models.insert( node.graphic_node->nodeDataModel() );
+    }
+
+    // another tree in between, with different names and ports
+    main_win->loadFromXML( readFile(":/test_xml_key_reordering_issue.xml") );
+    main_win->loadFromXML( file_xml );
+
+    const AbsBehaviorTree tree = getAbstractTree();
+    QVERIFY( tree == first_tree );
+
+    size_t reused = 0;
+    std::set<int> uids;
+    for (const auto& node: tree.nodes())
+    {
+        reused += first_models.count( node.graphic_node->nodeDataModel() );
+        auto bt_model = dynamic_cast<BehaviorTreeDataModel*>( node.graphic_node->nodeDataModel() );
+        QVERIFY( uids.insert( bt_model->UID() ).second );
+    }
+    QVERIFY( reused > 0 );
+
+    // the painted mode is the one at hand-out, not the one at recycle time
+    auto& registry = main_win->currentTabInfo()->scene()->registry();
+    auto model = registry.create( "AlwaysFailure" );
+    auto recycled = model.get();
+    const int recycled_uid = dynamic_cast<BehaviorTreeDataModel*>( recycled )->UID();
+    {
+        PaintedByDefaultScope scope( false );
+        registry.recycle( std::move(model) );
+    }
+    {
+        PaintedByDefaultScope scope( true );
+        model = registry.create( "AlwaysFailure" );
+    }
+    QCOMPARE( model.get(), recycled );
+    auto bt_model = dynamic_cast<BehaviorTreeDataModel*>( model.get() );
+    QVERIFY( bt_model->painted() );
+    QVERIFY( bt_model->UID() != recycled_uid );
+
+    // bounded for all the names together
+    registry.setTotalPoolCapacity( 1 );
+    QVERIFY( registry.pooledModelsCount() <= 1 );
+    registry.recycle( std::move(model) );
+    registry.recycle( registry.create( "AlwaysSuccess" ) );
+    QCOMPARE( registry.pooledModelsCount(), size_t(1) );
+    registry.setTotalPoolCapacity( 4096 );
+}
+
+void EditorTest::nodesStyleCache()
+{
+    auto& nodes_style = NodesStyle::instance();
+
+    auto failure = nodes_style.style( NodeType::ACTION, "AlwaysFailure" );
+    QCOMPARE( failure->caption_alias, QString("Failure") );
+    QCOMPARE( failure->caption_color, QColor("#ff2222") );
+    QVERIFY( failure->icon_renderer );
+
+    // resolved once, icon shared by the models with the same color
+    QCOMPARE( nodes_style.style( NodeType::ACTION, "AlwaysFailure" ), failure );
+    auto force_failure = nodes_style.style( NodeType::DECORATOR, "ForceFailure" );
+    QCOMPARE( force_failure->icon_renderer, failure->icon_renderer );
+
+    const QPixmap icon = nodes_style.iconPixmap( *failure, QSize(20,20), 2.0 );
+    QCOMPARE( icon.size(), QSize(40,40) );
+    QCOMPARE( nodes_style.iconPixmap( *failure, QSize(20,20), 1.8 ).cacheKey(), icon.cacheKey() );
+
+    QTemporaryFile style_file;
+    QVERIFY( style_file.open() );
+    style_file.write( R"({ "AlwaysFailure": { "caption_color": "#0000ff" } })" );
+    style_file.close();
+
+    int changes = 0;
+    auto connection = connect( &nodes_style, &NodesStyle::styleChanged, [&changes](){ changes++; } );
+    nodes_style.setStyleFile( style_file.fileName() );
+    QCOMPARE( changes, 1 );
+
+    auto custom = nodes_style.style( NodeType::ACTION, "AlwaysFailure" );
+    QCOMPARE( custom->caption_color, QColor("#0000ff") );
+    QVERIFY( custom->icon.isEmpty() );
+
+    nodes_style.setStyleFile( QString() );
+    disconnect( connection );
+    QCOMPARE( nodes_style.style( NodeType::ACTION, "AlwaysFailure" )->caption_color,
+              QColor("#ff2222") );
+}
+
+void EditorTest::paintedNodes()
+{
+    QString file_xml = readFile(":/crossdoor_with_subtree.xml");
+    main_win->on_actionClear_triggered();
+    main_win->loadFromXML( file_xml );
+
+    auto container = main_win->currentTabInfo();
+    const AbsBehaviorTree tree = getAbstractTree();
+
+    // read-only: no widgets, the size comes from the painted layout
+    container->lockEditing( true );
+    for (const auto& node: tree.nodes())
+    {
+        auto bt_model = dynamic_cast<BehaviorTreeDataModel*>( node.graphic_node->nodeDataModel() );
+        QVERIFY( bt_model->painted() );
+        QVERIFY( bt_model->embeddedWidget() == nullptr );
+        QCOMPARE( node.graphic_node->nodeGeometry().contentSize(), bt_model->paintedSize() );
+    }
+    sleepAndRefresh( 200 );
+    QVERIFY( getAbstractTree() == tree );
+
+    container->lockEditing( false );
+    for (const auto& node: tree.nodes())
+    {
+        QVERIFY( node.graphic_node->nodeDataModel()->embeddedWidget() != nullptr );
+    }
+    QVERIFY( getAbstractTree() == tree );
+}
+
+void EditorTest::detailLevels()
+{
+    QString file_xml = readFile(":/crossdoor_with_subtree.xml");
+    main_win->on_actionClear_triggered();
+    main_win->loadFromXML( file_xml );
+
+    auto container = main_win->currentTabInfo();
+    auto view = container->view();
+    auto scene = container->scene();
+    const AbsBehaviorTree tree = getAbstractTree();
+
+    auto widgetsVisible = [&]() -> bool
+    {
+        for (const auto& node: tree.nodes())
+        {
+            auto widget = node.graphic_node->nodeDataModel()->embeddedWidget();
+            if( widget && !widget->isVisible() )
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    view->resetTransform();
+    sleepAndRefresh( 100 );
+    QVERIFY( scene->detailLevel() == QtNodes::DetailLevel::Full );
+    QVERIFY( widgetsVisible() );
+
+    // set by the change of the transform, not by the next paint
+    view->scale( 0.3, 0.3 );
+    QVERIFY( scene->detailLevel() == QtNodes::DetailLevel::Simplified );
+    sleepAndRefresh( 100 );
+    QVERIFY( !widgetsVisible() );
+
+    view->scale( 0.5, 0.5 );
+    QVERIFY( scene->detailLevel() == QtNodes::DetailLevel::Schematic );
+
+    view->resetTransform();
+    sleepAndRefresh( 100 );
+    QVERIFY( scene->detailLevel() == QtNodes::DetailLevel::Full );
+    QVERIFY( widgetsVisible() );
+    QVERIFY( getAbstractTree() == tree );
+}
+
+void EditorTest::virtualizedWidgets()
+{
+    QString xml = "<root main_tree_to_execute=\"BehaviorTree\">"
+                  "<BehaviorTree ID=\"BehaviorTree\"><Sequence>";
+    for (int i = 0; i < 400; i++)
+    {
+        xml += QString("<Sequence name=\"step_%1\">"
+                       "<AlwaysSuccess/>"
+                       "<SetBlackboard value=\"%1\" output_key=\"key_%1\"/>"
+                       "</Sequence>").arg(i);
+    }
+    xml += "</Sequence></BehaviorTree></root>";
+
+    main_win->on_actionClear_triggered();
+    main_win->loadFromXML( xml );
+
+    auto container = main_win->currentTabInfo();
+    auto view = container->view();
+    const AbsBehaviorTree tree = getAbstractTree();
+    QVERIFY( tree.nodesCount() > GraphicContainer::VIRTUALIZATION_THRESHOLD );
+
+    auto paintedCount = [&]() -> size_t
+    {
+        size_t count = 0;
+        for (const auto& node: tree.nodes())
+        {
+            auto bt_model = dynamic_cast<BehaviorTreeDataModel*>( node.graphic_node->nodeDataModel() );
+            if( bt_model->painted() )
+            {
+                count++;
+            }
+        }
+        return count;
+    };
+
+    auto graphicsCount = [&]() -> size_t
+    {
+        size_t count = 0;
+        for (const auto& node: tree.nodes())
+        {
+            if( node.graphic_node->hasGraphicsObject() )
+            {
+                count++;
+            }
+        }
+        return count;
+    };
+
+    // zoomed out, no node needs its widgets
+    container->updateNodeWidgets();
+    QCOMPARE( paintedCount(), tree.nodesCount() );
+
+    // and only some of them have a graphics object, the scene paints the others
+    auto scene = container->scene();
+    QVERIFY( scene->graphicsOnDemand() );
+    QVERIFY( graphicsCount() <= size_t(GraphicContainer::MAX_NODE_GRAPHICS) );
+
+    std::vector<QPointF> positions;
+    for (const auto& node: tree.nodes())
+    {
+        positions.push_back( scene->getNodePosition( *node.graphic_node ) );
+    }
+
+    // at full detail too: their fields are edited without widgets
+    const auto& last_node = tree.nodes().back();
+    view->resetTransform();
+    view->centerOn( last_node.graphic_node->nodeGraphicsObject().sceneBoundingRect().center() );
+    container->updateNodeWidgets();
+
+    QCOMPARE( paintedCount(), tree.nodesCount() );
+    QVERIFY( last_node.graphic_node->nodeDataModel()->embeddedWidget() == nullptr );
+
+    // close to the last node, far from the first ones
+    QVERIFY( last_node.graphic_node->hasGraphicsObject() );
+    QVERIFY( !tree.nodes().front().graphic_node->hasGraphicsObject() );
+    QVERIFY( graphicsCount() < size_t(GraphicContainer::MAX_NODE_GRAPHICS) );
+    QVERIFY( size_t(scene->items().size()) < tree.nodesCount() / 2 );
+
+    container->zoomHomeView();
+    container->updateNodeWidgets();
+    QCOMPARE( paintedCount(), tree.nodesCount() );
+
+    // created and destroyed, the graphics objects don't move the nodes
+    QVERIFY( getAbstractTree() == tree );
+    for (size_t i = 0; i < tree.nodesCount(); i++)
+    {
+        QCOMPARE( scene->getNodePosition( *tree.node(i)->graphic_node ), positions[i] );
+    }
+}
+
+void EditorTest::editPaintedFields()
+{
+    QString xml = "<root main_tree_to_execute=\"BehaviorTree\">"
+                  "<BehaviorTree ID=\"BehaviorTree\"><Sequence>"
+                  "<SetBlackboard name=\"set_key\" value=\"1\" output_key=\"key\"/>"
+                  "</Sequence></BehaviorTree></root>";
+
+    main_win->on_actionClear_triggered();
+    main_win->loadFromXML( xml );
+
+    auto container = main_win->currentTabInfo();
+    container->view()->resetTransform();
+
+    QtNodes::Node* node = getAbstractTree().findFirstNode("set_key")->graphic_node;
+    auto bt_model = dynamic_cast<BehaviorTreeDataModel*>( node->nodeDataModel() );
+    bt_model->setPainted( true );
+    bt_model->releaseWidgets();
+
+    auto& graphic_object = node->nodeGraphicsObject();
+    auto fieldEditor = [&]() -> QLineEdit*
+    {
+        for (auto item: graphic_object.childItems())
+        {
+            if( auto proxy = dynamic_cast<QGraphicsProxyWidget*>( item ) )
+            {
+                return qobject_cast<QLineEdit*>( proxy->widget() );
+            }
+        }
+        return nullptr;
+    };
+
+    // the last row is the field of the last port, output_key
+    const QRectF body( node->nodeGeometry().widgetPosition(), QSizeF( bt_model->paintedSize() ) );
+    const QPointF field_pos = graphic_object.mapToScene( body.bottomRight() - QPointF(3, 3) );
+
+    // nothing to edit in the caption
+    QVERIFY( !container->editPaintedField( *node, graphic_object.mapToScene( body.topLeft() + QPointF(3, 3) ) ) );
+    QVERIFY( fieldEditor() == nullptr );
+
+    container->onNodeDoubleClicked( *node, field_pos );
+    QLineEdit* editor = fieldEditor();
+    QVERIFY( editor != nullptr );
+    QCOMPARE( editor->text(), QString("key") );
+    QVERIFY( bt_model->embeddedWidget() == nullptr );
+
+    editor->setText( "new_key" );
+    emit editor->editingFinished();
+    sleepAndRefresh( 50 );
+
+    QVERIFY( fieldEditor() == nullptr );
+    QCOMPARE( bt_model->getCurrentPortMapping().at("output_key"), QString("new_key") );
+    QCOMPARE( getAbstractTree().findFirstNode("set_key")->ports_mapping.at("output_key"),
+              QString("new_key") );
+
+    // an undoable change, like the ones made with the widgets
+    main_win->onUndoInvoked();
+    sleepAndRefresh( 50 );
+    QCOMPARE( getAbstractTree().findFirstNode("set_key")->ports_mapping.at("output_key"),
+              QString("key") );
+
+    // read-only trees are not edited
+    container = main_win->currentTabInfo();
+    node = getAbstractTree().findFirstNode("set_key")->graphic_node;
+    container->lockEditing( true );
+    QVERIFY( !container->editPaintedField( *node, node->nodeGraphicsObject().sceneBoundingRect().center() ) );
+    container->lockEditing( false );
+}
+
+void EditorTest::coalescedStyleUpdates()
+{
+    QString xml = "<root main_tree_to_execute=\"BehaviorTree\">"
+                  "<BehaviorTree ID=\"BehaviorTree\"><Sequence>"
+                  "<AlwaysSuccess/><Fallback><AlwaysFailure/><AlwaysSuccess/></Fallback>"
+                  "</Sequence></BehaviorTree></root>";
+
+    main_win->on_actionClear_triggered();
+    main_win->loadFromXML( xml );
+
+    auto container = main_win->currentTabInfo();
+    const int nodes_count = int( getAbstractTree().nodesCount() );
+    container->flushStyleUpdates();
+    QCOMPARE( container->pendingStyleUpdates(), size_t(0) );
+
+    // the root is left alone: when RUNNING, it resets the whole tree
+    auto statusOfAll = [&](NodeStatus status)
+    {
+        std::vector<std::pair<int, NodeStatus>> node_status;
+        for (int index = 2; index < nodes_count; index++)
+        {
+            node_status.push_back( {index, status} );
+        }
+        return node_status;
+    };
+
+    // a burst of changes: each node is repainted once, in a single flush
+    main_win->onChangeNodesStatus( "BehaviorTree", statusOfAll(NodeStatus::RUNNING) );
+    main_win->onChangeNodesStatus( "BehaviorTree", statusOfAll(NodeStatus::FAILURE) );
+    main_win->onChangeNodesStatus( "BehaviorTree", statusOfAll(NodeStatus::SUCCESS) );
+    QCOMPARE( container->pendingStyleUpdates(), size_t(nodes_count - 2) );
+
+    sleepAndRefresh( 100 );
+    QCOMPARE( container->pendingStyleUpdates(), size_t(0) );
+
+    // the same style again: nothing to repaint
+    main_win->onChangeNodesStatus( "BehaviorTree", statusOfAll(NodeStatus::SUCCESS) );
+    QCOMPARE( container->pendingStyleUpdates(), size_t(0) );
+}
+
+void EditorTest::openGLViewport()
+{
+    QString file_xml = readFile(":/crossdoor_with_subtree.xml");
+    main_win->on_actionClear_triggered();
+    main_win->loadFromXML( file_xml );
+
+    auto container = main_win->currentTabInfo();
+    auto view = container->view();
+    const AbsBehaviorTree tree = getAbstractTree();
+
+    // OpenGL, or the raster viewport kept as it was
+    const bool enabled = view->setOpenGLViewport( true );
+    QCOMPARE( view->isOpenGLViewport(), enabled );
+    if( qgetenv( "QT_XCB_GL_INTEGRATION" ) == "none" )
+    {
+        QVERIFY( !enabled );
+        QCOMPARE( view->viewportUpdateMode(), QGraphicsView::SmartViewportUpdate );
+    }
+
+    container->zoomHomeView();
+    sleepAndRefresh( 100 );
+    QVERIFY( !view->grab().isNull() );
+
+    QVERIFY( view->setOpenGLViewport( false ) );
+    QVERIFY( !view->isOpenGLViewport() );
+    QCOMPARE( view->viewportUpdateMode(), QGraphicsView::SmartViewportUpdate );
+    QVERIFY( getAbstractTree() == tree );
+}
+
 QTEST_MAIN(EditorTest)
 
 #include "editor_test.moc"
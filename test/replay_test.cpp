@@ -1,5 +1,8 @@
 #include "groot_test_base.h"
 #include "bt_editor/sidepanel_replay.h"
+#include "bt_editor/utils.h"
+#include "bt_editor/flatbuffer_tree_view.h"
+#include "bt_editor/replay_exporter.h"
 #include <QAction>
 
 class ReplyTest : public GrootTestBase
@@ -14,6 +17,14 @@ private slots:
     void initTestCase();
     void cleanupTestCase();
     void basicLoad();
+    void corruptTransitions();
+    void sessionLoad();
+    void checkpointedDecoder();
+    void replayTimeline();
+    void resolveNodesStatus();
+    void compareLogs();
+    void flatbufferTreeView();
+    void exportDetailLevel();
 };
 
 
@@ -41,6 +52,269 @@ void ReplyTest::basicLoad()
     sidepanel_replay->loadLog( log );
 
     QCOMPARE( sidepanel_replay->transitionsCount(), size_t(27) );
+
+    // nothing to edit, nothing to embed
+    for (const auto& node: getAbstractTree().nodes())
+    {
+        QVERIFY( node.graphic_node->nodeDataModel()->embeddedWidget() == nullptr );
+        QVERIFY( node.graphic_node->nodeDataModel()->painterDelegate() != nullptr );
+    }
+}
+
+void ReplyTest::corruptTransitions()
+{
+    auto sidepanel_replay = main_win->findChild<SidepanelReplay*>("SidepanelReplay");
+    QVERIFY2( sidepanel_replay, "Can't get pointer to SidepanelReplay" );
+
+    QByteArray log = readFile("://crossdoor_trace.fbl");
+
+    // corrupt the UID of the first transition and truncate the last one
+    const uint32_t header_size = flatbuffers::ReadScalar<uint32_t>( log.data() );
+    const int uid_offset = 4 + header_size + 8;
+    log[uid_offset]   = char(0xFF);
+    log[uid_offset+1] = char(0xFF);
+    log.chop(5);
+
+    testMessageBox(500, TEST_LOCATION(), [&]()
+    {
+        // should warn, but not fail
+        sidepanel_replay->loadLog( log );
+    });
+
+    QCOMPARE( sidepanel_replay->transitionsCount(), size_t(25) );
+}
+
+void ReplyTest::sessionLoad()
+{
+    auto sidepanel_replay = main_win->findChild<SidepanelReplay*>("SidepanelReplay");
+    QVERIFY2( sidepanel_replay, "Can't get pointer to SidepanelReplay" );
+
+    sidepanel_replay->loadSession( { "://crossdoor_trace.fbl", "://crossdoor_trace.fbl" } );
+
+    QCOMPARE( sidepanel_replay->sessionFilesCount(), size_t(2) );
+
+    // one timeline: the second file follows the first one
+    const auto& transitions = sidepanel_replay->transitions();
+    QCOMPARE( transitions.size(), size_t(54) );
+    for (size_t row = 1; row < transitions.size(); row++)
+    {
+        QVERIFY( transitions[row].timestamp >= transitions[row-1].timestamp );
+    }
+    QVERIFY( transitions[27].timestamp - transitions[26].timestamp <= 1.0 );
+}
+
+void ReplyTest::checkpointedDecoder()
+{
+    const size_t nodes_count = 6;
+    const NodeStatus statuses[] = { NodeStatus::RUNNING, NodeStatus::SUCCESS,
+                                    NodeStatus::FAILURE, NodeStatus::IDLE };
+
+    // pseudo-random transitions, with the root restarting every now and then
+    std::vector<ReplayTransition> transitions;
+    std::vector<NodeStatus> last_status( nodes_count, NodeStatus::IDLE );
+    for (int i = 0; i < 500; i++)
+    {
+        ReplayTransition trans;
+        trans.index = (i % 37 == 0) ? 1 : 1 + (i * 7919) % (nodes_count - 1);
+        trans.status = (i % 37 == 0) ? NodeStatus::RUNNING : statuses[(i * 31) % 4];
+        trans.prev_status = last_status[trans.index];
+        trans.timestamp = i * 0.01;
+        last_status[trans.index] = trans.status;
+        transitions.push_back( trans );
+    }
+    UpdateRestartPoints( nodes_count, transitions );
+
+    ReplayDecoder decoder;
+    decoder.build( nodes_count, transitions, 8 );
+
+    for (int row = 0; row < int(transitions.size()); row++)
+    {
+        // the status sequence replayed from the beginning of the execution
+        std::vector<std::pair<int, NodeStatus>> sequence;
+        for (int t = transitions[row].nearest_restart_transition_index; t <= row; t++)
+        {
+            sequence.push_back( { transitions[t].index, transitions[t].status } );
+        }
+        const auto expected = ResolveNodesStatus( nodes_count, sequence );
+
+        QCOMPARE( decoder.statusAt(row) == expected, true );
+        QCOMPARE( ResolveNodesStatus( nodes_count, decoder.sequenceAt(row) ) == expected, true );
+    }
+}
+
+void ReplyTest::replayTimeline()
+{
+    const size_t nodes_count = 3;
+    auto transition = [](int index, NodeStatus prev, NodeStatus status,
+                         double timestamp, bool restart)
+    {
+        ReplayTransition trans;
+        trans.index = index;
+        trans.prev_status = prev;
+        trans.status = status;
+        trans.timestamp = timestamp;
+        trans.is_tree_restart = restart;
+        trans.nearest_restart_transition_index = 0;
+        return trans;
+    };
+
+    ReplayTimeline timeline;
+
+    // an empty log
+    timeline.build( nodes_count, {} );
+    QCOMPARE( timeline.nodesCount(), nodes_count );
+    QVERIFY( timeline.intervals(1).empty() );
+    QVERIFY( timeline.executionsStart().empty() );
+    QCOMPARE( timeline.firstIntervalEndingAfter( 1, 0.0 ), size_t(0) );
+    QCOMPARE( timeline.runningTime( 1, 0.0, 10.0 ), 0.0 );
+    QCOMPARE( timeline.executionRange( 1.0 ), std::make_pair( 0.0, 0.0 ) );
+
+    // two executions; the root is still RUNNING when the log ends
+    const std::vector<ReplayTransition> transitions = {
+        transition( 1, NodeStatus::IDLE,    NodeStatus::RUNNING, 0.0, true ),
+        transition( 2, NodeStatus::IDLE,    NodeStatus::RUNNING, 1.0, false ),
+        transition( 2, NodeStatus::RUNNING, NodeStatus::SUCCESS, 3.0, false ),
+        transition( 1, NodeStatus::RUNNING, NodeStatus::SUCCESS, 4.0, false ),
+        transition( 1, NodeStatus::SUCCESS, NodeStatus::RUNNING, 6.0, true ),
+        transition( 2, NodeStatus::SUCCESS, NodeStatus::RUNNING, 7.0, false ),
+        transition( 2, NodeStatus::RUNNING, NodeStatus::FAILURE, 9.0, false ) };
+
+    timeline.build( nodes_count, transitions );
+    QCOMPARE( timeline.startTime(), 0.0 );
+    QCOMPARE( timeline.endTime(), 9.0 );
+    QVERIFY( timeline.intervals(0).empty() );
+
+    const auto& root_intervals = timeline.intervals(1);
+    QCOMPARE( root_intervals.size(), size_t(2) );
+    QCOMPARE( root_intervals[0].start, 0.0 );
+    QCOMPARE( root_intervals[0].end, 4.0 );
+    QCOMPARE( root_intervals[1].start, 6.0 );
+    QCOMPARE( root_intervals[1].end, 9.0 ); // closed at the end of the log
+    QCOMPARE( timeline.intervals(2).size(), size_t(2) );
+
+    QCOMPARE( timeline.firstIntervalEndingAfter( 1, 0.0 ), size_t(0) );
+    QCOMPARE( timeline.firstIntervalEndingAfter( 1, 4.0 ), size_t(0) );
+    QCOMPARE( timeline.firstIntervalEndingAfter( 1, 4.5 ), size_t(1) );
+    QCOMPARE( timeline.firstIntervalEndingAfter( 1, 10.0 ), size_t(2) );
+
+    QCOMPARE( timeline.runningTime( 1, 0.0, 9.0 ), 7.0 );
+    QCOMPARE( timeline.runningTime( 2, 0.0, 9.0 ), 4.0 );
+    // ranges starting and ending inside an interval
+    QCOMPARE( timeline.runningTime( 1, 2.0, 7.0 ), 3.0 );
+    QCOMPARE( timeline.runningTime( 2, 2.0, 8.0 ), 2.0 );
+    QCOMPARE( timeline.runningTime( 1, 1.0, 2.0 ), 1.0 );
+    // between two intervals
+    QCOMPARE( timeline.runningTime( 1, 4.5, 5.5 ), 0.0 );
+
+    QCOMPARE( timeline.executionsStart(), std::vector<double>({ 0.0, 6.0 }) );
+    QCOMPARE( timeline.executionRange( 3.0 ), std::make_pair( 0.0, 6.0 ) );
+    QCOMPARE( timeline.executionRange( 6.0 ), std::make_pair( 6.0, 9.0 ) );
+    QCOMPARE( timeline.executionRange( 8.0 ), std::make_pair( 6.0, 9.0 ) );
+}
+
+void ReplyTest::resolveNodesStatus()
+{
+    typedef std::pair<NodeStatus, NodeStatus> StatusPair;
+    const size_t nodes_count = 4;
+    const StatusPair idle( NodeStatus::IDLE, NodeStatus::IDLE );
+
+    QVERIFY( ResolveNodesStatus( nodes_count, {} ) == std::vector<StatusPair>( nodes_count, idle ) );
+
+    // the previous status of each node is kept, unknown nodes are ignored
+    auto result = ResolveNodesStatus( nodes_count, { {2, NodeStatus::RUNNING},
+                                                     {-1, NodeStatus::RUNNING},
+                                                     {7, NodeStatus::FAILURE},
+                                                     {2, NodeStatus::SUCCESS} } );
+    QVERIFY( result[2] == StatusPair( NodeStatus::SUCCESS, NodeStatus::RUNNING ) );
+    QVERIFY( result[1] == idle );
+    QVERIFY( result[3] == idle );
+
+    // the root becoming RUNNING resets the nodes that didn't change since
+    result = ResolveNodesStatus( nodes_count, { {2, NodeStatus::SUCCESS},
+                                                {3, NodeStatus::FAILURE},
+                                                {1, NodeStatus::RUNNING},
+                                                {3, NodeStatus::RUNNING} } );
+    QVERIFY( result[0] == idle );
+    QVERIFY( result[1] == StatusPair( NodeStatus::RUNNING, NodeStatus::IDLE ) );
+    QVERIFY( result[2] == idle );
+    QVERIFY( result[3] == StatusPair( NodeStatus::RUNNING, NodeStatus::FAILURE ) );
+}
+
+void ReplyTest::compareLogs()
+{
+    auto sidepanel_replay = main_win->findChild<SidepanelReplay*>("SidepanelReplay");
+    QVERIFY2( sidepanel_replay, "Can't get pointer to SidepanelReplay" );
+
+    QByteArray log = readFile("://crossdoor_trace.fbl");
+    sidepanel_replay->loadLog( log );
+    QCOMPARE( sidepanel_replay->loadComparisonLog( log, "crossdoor_trace.fbl" ), true );
+    QCOMPARE( sidepanel_replay->comparisonTransitionsCount(), size_t(27) );
+
+    // the same log is aligned with itself, both by time and by execution
+    QCOMPARE( sidepanel_replay->comparisonRow( 26, SidepanelReplay::ALIGN_BY_TIME ), 26 );
+    QCOMPARE( sidepanel_replay->comparisonRow( 26, SidepanelReplay::ALIGN_BY_EXECUTION ), 26 );
+
+    sidepanel_replay->closeComparison();
+    QCOMPARE( sidepanel_replay->comparisonTransitionsCount(), size_t(0) );
+}
+
+void ReplyTest::flatbufferTreeView()
+{
+    const QByteArray log = readFile("://crossdoor_trace.fbl");
+    const uint32_t header_size = flatbuffers::ReadScalar<uint32_t>( log.data() );
+    const QByteArray header = log.mid( 4, int(header_size) );
+
+    FlatbufferTreeView view;
+    QVERIFY( view.empty() );
+    QVERIFY( view.load( header ) );
+    QVERIFY( !view.load( header ) ); // same tree
+
+    const AbsBehaviorTree tree = view.toAbsTree();
+    QCOMPARE( tree.nodesCount(), view.nodesCount() );
+    QCOMPARE( tree.rootNode()->model->registration_ID, QString("Root") );
+
+    for (size_t index = 1; index < view.nodesCount(); index++)
+    {
+        const auto& node = tree.nodes()[index];
+        QCOMPARE( view.instanceName(index), node.instance_name );
+        QCOMPARE( view.registrationID(index), node.model->registration_ID );
+        QCOMPARE( view.indexOf( view.fbNode(index)->uid() ), int(index) );
+
+        // a single instance of each model
+        for (const auto& other: tree.nodes())
+        {
+            if( other.model->registration_ID == node.model->registration_ID )
+            {
+                QVERIFY( other.model == node.model );
+            }
+        }
+    }
+    QCOMPARE( view.indexOf( 0xFFFF ), -1 );
+
+    view.clear();
+    QVERIFY( view.empty() );
+    QCOMPARE( view.toAbsTree().nodesCount(), size_t(0) );
+}
+
+void ReplyTest::exportDetailLevel()
+{
+    auto sidepanel_replay = main_win->findChild<SidepanelReplay*>("SidepanelReplay");
+    QVERIFY2( sidepanel_replay, "Can't get pointer to SidepanelReplay" );
+    sidepanel_replay->loadLog( readFile("://crossdoor_trace.fbl") );
+
+    auto container = main_win->getTabByName("BehaviorTree");
+    auto scene = container->scene();
+
+    // zoomed out, but the frames are exported at full detail
+    container->view()->scale( 0.1, 0.1 );
+    QVERIFY( scene->detailLevel() == QtNodes::DetailLevel::Schematic );
+    {
+        ReplayExporter exporter( container );
+        QVERIFY( scene->detailLevel() == QtNodes::DetailLevel::Full );
+    }
+    QVERIFY( scene->detailLevel() == QtNodes::DetailLevel::Schematic );
+
+    container->zoomHomeView();
 }
 
 QTEST_MAIN(ReplyTest)